@@ -3,6 +3,15 @@
 namespace mrta
 {
 
+struct ParameterEvent
+{
+    juce::String ID;
+    float value { 0.f };
+
+    // Sample position on the ParameterManager clock
+    juce::int64 timestamp { 0 };
+};
+
 template<size_t Capacity>
 class ParameterFIFO
 {
@@ -18,7 +27,7 @@ public:
         abstractFIFO.reset();
     }
 
-    bool pushParameter(const juce::String& parameterID, float newValue)
+    bool pushParameter(const juce::String& parameterID, float newValue, juce::int64 timestamp = 0)
     {
         if (abstractFIFO.getFreeSpace() == 0)
             return false;
@@ -26,15 +35,15 @@ public:
         auto scope = abstractFIFO.write(1);
 
         if (scope.blockSize1 > 0)
-            buffer[scope.startIndex1] = std::make_pair(parameterID, newValue);
+            buffer[scope.startIndex1] = ParameterEvent { parameterID, newValue, timestamp };
 
         if (scope.blockSize2 > 0)
-            buffer[scope.startIndex2] = std::make_pair(parameterID, newValue);
+            buffer[scope.startIndex2] = ParameterEvent { parameterID, newValue, timestamp };
 
         return true;
     }
 
-    std::pair<bool, std::pair<juce::String, float>> popParameter()
+    std::pair<bool, ParameterEvent> popParameter()
     {
         if (abstractFIFO.getNumReady() == 0)
             return {};
@@ -47,12 +56,12 @@ public:
         if (scope.blockSize2 > 0)
             return {true, buffer[scope.startIndex2] };
 
-        return { false, { "", 0.f } };
+        return { false, {} };
     }
 
 private:
     juce::AbstractFifo abstractFIFO;
-    std::array<std::pair<juce::String, float>, Capacity> buffer;
+    std::array<ParameterEvent, Capacity> buffer;
 
     JUCE_DECLARE_NON_COPYABLE(ParameterFIFO)
     JUCE_DECLARE_NON_MOVEABLE(ParameterFIFO)
@@ -85,21 +85,40 @@ void ParameterManager::updateParameters(bool force)
                 p.second(raw->load(), true);
         });
         fifo.clear();
+        numPendingEvents = 0;
     }
 
     auto newParam = fifo.popParameter();
     while (newParam.first)
     {
-        auto it = callbacks.find(newParam.second.first);
-        if (it != callbacks.end())
-            it->second(newParam.second.second, false);
+        callParameterCallback(newParam.second);
         newParam = fifo.popParameter();
     }
+
+    // Without block positions scheduled events are all due now
+    for (size_t i = 0; i < numPendingEvents; ++i)
+        callParameterCallback(pendingEvents[i]);
+    numPendingEvents = 0;
+}
+
+bool ParameterManager::pushParameterEvent(const juce::String& ID, float value, int sampleOffset)
+{
+    if (numPendingEvents == MaxPendingEvents)
+        return false;
+
+    addPendingEvent({ ID, value, samplePosition.load(std::memory_order_relaxed) + std::max(sampleOffset, 0) });
+    return true;
+}
+
+juce::int64 ParameterManager::getSamplePosition() const
+{
+    return samplePosition.load(std::memory_order_relaxed);
 }
 
 void ParameterManager::clearParameterQueue()
 {
     fifo.clear();
+    numPendingEvents = 0;
 }
 
 const std::vector<mrta::ParameterInfo>& ParameterManager::getParameters() const
@@ -126,7 +145,60 @@ void ParameterManager::getStateInformation(juce::MemoryBlock& destData)
 
 void ParameterManager::parameterChanged(const juce::String& parameterID, float newValue)
 {
-    fifo.pushParameter(parameterID, newValue);
+    fifo.pushParameter(parameterID, newValue, samplePosition.load(std::memory_order_relaxed));
+}
+
+void ParameterManager::callParameterCallback(const mrta::ParameterEvent& event)
+{
+    auto it = callbacks.find(event.ID);
+    if (it != callbacks.end())
+        it->second(event.value, false);
+}
+
+void ParameterManager::addPendingEvent(const mrta::ParameterEvent& event)
+{
+    // No room left, apply it right away
+    if (numPendingEvents == MaxPendingEvents)
+    {
+        callParameterCallback(event);
+        return;
+    }
+
+    // Insert after any event with the same or an earlier timestamp, keeping the arrival order
+    size_t i { numPendingEvents };
+    while (i > 0 && pendingEvents[i - 1].timestamp > event.timestamp)
+    {
+        pendingEvents[i] = std::move(pendingEvents[i - 1]);
+        --i;
+    }
+
+    pendingEvents[i] = event;
+    ++numPendingEvents;
+}
+
+void ParameterManager::drainParameterQueue()
+{
+    auto newParam = fifo.popParameter();
+    while (newParam.first)
+    {
+        addPendingEvent(newParam.second);
+        newParam = fifo.popParameter();
+    }
+}
+
+void ParameterManager::dispatchParameterEvents(juce::int64 position)
+{
+    size_t numDue { 0 };
+    while (numDue < numPendingEvents && pendingEvents[numDue].timestamp <= position)
+        callParameterCallback(pendingEvents[numDue++]);
+
+    if (numDue > 0)
+    {
+        std::move(pendingEvents.begin() + static_cast<std::ptrdiff_t>(numDue),
+                  pendingEvents.begin() + static_cast<std::ptrdiff_t>(numPendingEvents),
+                  pendingEvents.begin());
+        numPendingEvents -= numDue;
+    }
 }
 
 }
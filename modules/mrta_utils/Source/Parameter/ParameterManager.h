@@ -35,6 +35,51 @@ public:
     // good way to guarantee the DSP has updated parameters
     void updateParameters(bool force = false);
 
+    // Schedule a parameter change at a sample offset into the next processed block
+    // This method is meant for the audio thread only, for event sources that carry
+    // sample positions, like MIDI controllers, and before calling processSubBlocks
+    bool pushParameterEvent(const juce::String& ID, float value, int sampleOffset);
+
+    // Alternative to updateParameters that keeps parameter changes sample accurate
+    // The block is split at parameter event boundaries and 'process(startSample, numSamples)'
+    // is called for each sub-block, right after the callbacks of the events due at its start
+    // Sub-blocks other than the last are at least 'minSubBlockSize' long, events falling closer
+    // are delayed to the next boundary, so dense automation can't explode the number of calls
+    // Events from the parameter listeners have no position inside the block, and are
+    // applied at the start of the next processed block, like updateParameters does,
+    // only events from pushParameterEvent land inside the block
+    template<typename ProcessFn>
+    void processSubBlocks(int numSamples, ProcessFn&& process, int minSubBlockSize = DefaultMinSubBlockSize)
+    {
+        drainParameterQueue();
+
+        const juce::int64 blockPosition { samplePosition.load(std::memory_order_relaxed) };
+        minSubBlockSize = std::max(minSubBlockSize, 1);
+
+        int startSample { 0 };
+        while (startSample < numSamples)
+        {
+            dispatchParameterEvents(blockPosition + startSample);
+
+            int endSample { numSamples };
+            if (numPendingEvents > 0)
+            {
+                const juce::int64 nextEvent { pendingEvents[0].timestamp - blockPosition };
+                if (nextEvent < numSamples)
+                    endSample = static_cast<int>(std::min(std::max(nextEvent, static_cast<juce::int64>(startSample + minSubBlockSize)),
+                                                          static_cast<juce::int64>(numSamples)));
+            }
+
+            process(startSample, endSample - startSample);
+            startSample = endSample;
+        }
+
+        samplePosition.store(blockPosition + numSamples, std::memory_order_relaxed);
+    }
+
+    // Sample position of the next block to be processed by processSubBlocks
+    juce::int64 getSamplePosition() const;
+
     // Empty the paramter event queue
     void clearParameterQueue();
 
@@ -59,12 +104,27 @@ public:
     // be called by user, it is used by the APVTS listerners only
     void parameterChanged(const juce::String& parameterID, float newValue) override;
 
+    static constexpr int DefaultMinSubBlockSize { 32 };
+    static constexpr size_t MaxPendingEvents { 64 };
+
 private:
     juce::AudioProcessorValueTreeState apvts;
     std::vector<mrta::ParameterInfo> parameters;
     mrta::ParameterFIFO<64> fifo;
     std::unordered_map<juce::String, Callback> callbacks;
 
+    // Sample clock advanced by processSubBlocks, used to timestamp events
+    std::atomic<juce::int64> samplePosition { 0 };
+
+    // Events waiting for their position, audio thread only, sorted by timestamp
+    std::array<mrta::ParameterEvent, MaxPendingEvents> pendingEvents;
+    size_t numPendingEvents { 0 };
+
+    void callParameterCallback(const mrta::ParameterEvent& event);
+    void addPendingEvent(const mrta::ParameterEvent& event);
+    void drainParameterQueue();
+    void dispatchParameterEvents(juce::int64 position);
+
     JUCE_DECLARE_NON_COPYABLE(ParameterManager)
     JUCE_DECLARE_NON_MOVEABLE(ParameterManager)
     JUCE_LEAK_DETECTOR(ParameterManager)
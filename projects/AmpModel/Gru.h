@@ -4,9 +4,10 @@
 #include <cmath>
 
 #include "GruParameters.h"
+#include "FastMath.h"
 
 
-template <size_t INPUT_SIZE, size_t OUTPUT_SIZE, size_t HIDDEN_SIZE>
+template <size_t INPUT_SIZE, size_t OUTPUT_SIZE, size_t HIDDEN_SIZE, DSP::FastMath::Quality QUALITY = DSP::FastMath::Fast>
 class Gru
 {
 public:
@@ -35,7 +36,7 @@ public:
     }    float sigmoid(float x) const
     {
         // Sigmoid function: σ(x) = 1 / (1 + e^(-x))
-        return 1.0f / (1.0f + std::exp(-x));
+        return DSP::FastMath::sigmoid<QUALITY>(x);
     }
 
     void process(float * const * output, const float * const * input, size_t num_samples)
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "MeterComponent.h"
+#include "MrtaLAF.h"
+
+class ChorusAudioProcessorEditor  : public juce::AudioProcessorEditor
+{
+public:
+    ChorusAudioProcessorEditor(ChorusAudioProcessor&);
+    ~ChorusAudioProcessorEditor() override;
+
+    static constexpr int METER_WIDTH { 40 };
+
+    void paint(juce::Graphics&) override;
+    void resized() override;
+
+private:
+    ChorusAudioProcessor& audioProcessor;
+    mrta::GenericParameterEditor genericParameterEditor;
+    GUI::MeterComponent meterComponent;
+    GUI::MrtaLAF laf;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ChorusAudioProcessorEditor)
+};
\ No newline at end of file
@@ -0,0 +1,146 @@
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+#include <algorithm>
+
+static const std::vector<mrta::ParameterInfo> Parameters
+{
+    { Param::ID::Enabled, Param::Name::Enabled, Param::Ranges::EnabledOff, Param::Ranges::EnabledOn, true },
+    { Param::ID::Mix,     Param::Name::Mix,     "",               0.5f,  Param::Ranges::MixMin,   Param::Ranges::MixMax,   Param::Ranges::MixInc,   Param::Ranges::MixSkw },
+    { Param::ID::Voices,  Param::Name::Voices,  Param::Ranges::VoicesLabels, 1 },
+    { Param::ID::Rate,    Param::Name::Rate,    Param::Units::Hz, 0.8f,  Param::Ranges::RateMin,  Param::Ranges::RateMax,  Param::Ranges::RateInc,  Param::Ranges::RateSkw },
+    { Param::ID::Depth,   Param::Name::Depth,   Param::Units::Ms, 3.f,   Param::Ranges::DepthMin, Param::Ranges::DepthMax, Param::Ranges::DepthInc, Param::Ranges::DepthSkw },
+    { Param::ID::Delay,   Param::Name::Delay,   Param::Units::Ms, 12.f,  Param::Ranges::DelayMin, Param::Ranges::DelayMax, Param::Ranges::DelayInc, Param::Ranges::DelaySkw }
+};
+
+ChorusAudioProcessor::ChorusAudioProcessor() :
+    parameterManager(*this, ProjectInfo::projectName, Parameters),
+    delayArena(DSP::Chorus::getRequiredBytes(MaxSampleRate)),
+    chorus(delayArena),
+    wetRamp(0.05f),
+    dryRamp(0.05f)
+{
+    meter.setTimeConstant(150.f);
+
+    parameterManager.registerParameterCallback(Param::ID::Enabled,
+    [this](float newValue, bool force)
+    {
+        enabled = newValue;
+        wetRamp.setTarget(std::clamp(enabled * mix, 0.f, 1.f), force);
+        dryRamp.setTarget(std::clamp((1.f - mix) * enabled + (1.f - enabled), 0.f, 1.f), force);
+    });
+
+    parameterManager.registerParameterCallback(Param::ID::Mix,
+    [this] (float value, bool force)
+    {
+        mix = value;
+        wetRamp.setTarget(std::clamp(enabled * mix, 0.f, 1.f), force);
+        dryRamp.setTarget(std::clamp((1.f - mix) * enabled + (1.f - enabled), 0.f, 1.f), force);
+    });
+
+    parameterManager.registerParameterCallback(Param::ID::Voices,
+    [this] (float value, bool /*force*/)
+    {
+        chorus.setVoices(DSP::Chorus::MinVoices + static_cast<unsigned int>(std::round(value)));
+    });
+
+    parameterManager.registerParameterCallback(Param::ID::Rate,
+    [this] (float value, bool /*force*/)
+    {
+        chorus.setRate(value);
+    });
+
+    parameterManager.registerParameterCallback(Param::ID::Depth,
+    [this] (float value, bool /*force*/)
+    {
+        chorus.setDepth(value);
+    });
+
+    parameterManager.registerParameterCallback(Param::ID::Delay,
+    [this] (float value, bool /*force*/)
+    {
+        chorus.setDelay(value);
+    });
+}
+
+ChorusAudioProcessor::~ChorusAudioProcessor()
+{
+}
+
+void ChorusAudioProcessor::prepareToPlay(double newSampleRate, int samplesPerBlock)
+{
+    const unsigned int numChannels { static_cast<unsigned int>(std::max(getMainBusNumInputChannels(), getMainBusNumOutputChannels())) };
+
+    // Re-slice the delay buffer from the preallocated arena
+    delayArena.reset();
+    chorus.prepare(newSampleRate, numChannels);
+    wetRamp.prepare(newSampleRate);
+    dryRamp.prepare(newSampleRate);
+    meter.prepare(newSampleRate, numChannels);
+
+    parameterManager.updateParameters(true);
+
+    fxBuffer.setSize(static_cast<int>(numChannels), samplesPerBlock);
+    fxBuffer.clear();
+}
+
+void ChorusAudioProcessor::releaseResources()
+{
+    chorus.clear();
+}
+
+void ChorusAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& /*midiMessages*/)
+{
+    juce::ScopedNoDenormals noDenormals;
+
+    const unsigned int numChannels { static_cast<unsigned int>(buffer.getNumChannels()) };
+
+    // Parameter changes land at their sample position inside the block
+    parameterManager.processSubBlocks(buffer.getNumSamples(), [&] (int startSample, int numSubBlockSamples)
+    {
+        juce::AudioBuffer<float> io(buffer.getArrayOfWritePointers(), static_cast<int>(numChannels), startSample, numSubBlockSamples);
+        juce::AudioBuffer<float> fx(fxBuffer.getArrayOfWritePointers(), static_cast<int>(numChannels), startSample, numSubBlockSamples);
+        const unsigned int numSamples { static_cast<unsigned int>(numSubBlockSamples) };
+
+        chorus.process(fx.getArrayOfWritePointers(), io.getArrayOfReadPointers(), numChannels, numSamples);
+        meter.process(fx.getArrayOfReadPointers(), numChannels, numSamples);
+
+        wetRamp.applyGain(fx.getArrayOfWritePointers(), numChannels, numSamples);
+        dryRamp.applyGain(io.getArrayOfWritePointers(), numChannels, numSamples);
+
+        for (int ch = 0; ch < static_cast<int>(numChannels); ++ch)
+            io.addFrom(ch, 0, fx, ch, 0, numSubBlockSamples);
+    });
+}
+
+void ChorusAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
+{
+    parameterManager.getStateInformation(destData);
+}
+
+void ChorusAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
+{
+    parameterManager.setStateInformation(data, sizeInBytes);
+}
+
+//==============================================================================
+bool ChorusAudioProcessor::hasEditor() const { return true; }
+juce::AudioProcessorEditor* ChorusAudioProcessor::createEditor() { return new ChorusAudioProcessorEditor(*this); }
+const juce::String ChorusAudioProcessor::getName() const { return JucePlugin_Name; }
+bool ChorusAudioProcessor::acceptsMidi() const { return false; }
+bool ChorusAudioProcessor::producesMidi() const { return false; }
+bool ChorusAudioProcessor::isMidiEffect() const { return false; }
+double ChorusAudioProcessor::getTailLengthSeconds() const { return static_cast<double>(DSP::Chorus::MaxDelayMs + DSP::Chorus::MaxDepthMs) * 0.001; }
+int ChorusAudioProcessor::getNumPrograms() { return 1; }
+int ChorusAudioProcessor::getCurrentProgram() { return 0; }
+void ChorusAudioProcessor::setCurrentProgram(int) { }
+const juce::String ChorusAudioProcessor::getProgramName (int) { return {}; }
+void ChorusAudioProcessor::changeProgramName (int, const juce::String&) { }
+//==============================================================================
+
+//==============================================================================
+// This creates new instances of the plugin..
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+    return new ChorusAudioProcessor();
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "Chorus.h"
+#include "Meter.h"
+
+namespace Param
+{
+    namespace ID
+    {
+        static const juce::String Enabled { "enabled" };
+        static const juce::String Mix { "mix" };
+        static const juce::String Voices { "voices" };
+        static const juce::String Rate { "rate" };
+        static const juce::String Depth { "depth" };
+        static const juce::String Delay { "delay" };
+    }
+
+    namespace Name
+    {
+        static const juce::String Enabled { "Enabled" };
+        static const juce::String Mix { "Mix" };
+        static const juce::String Voices { "Voices" };
+        static const juce::String Rate { "Rate" };
+        static const juce::String Depth { "Depth" };
+        static const juce::String Delay { "Delay" };
+    }
+
+    namespace Ranges
+    {
+        static constexpr float MixMin { 0.f };
+        static constexpr float MixMax { 1.f };
+        static constexpr float MixInc { 0.001f };
+        static constexpr float MixSkw { 1.0f };
+
+        static constexpr float RateMin { 0.01f };
+        static constexpr float RateMax { 5.f };
+        static constexpr float RateInc { 0.01f };
+        static constexpr float RateSkw { 0.5f };
+
+        static constexpr float DepthMin { 0.f };
+        static constexpr float DepthMax { DSP::Chorus::MaxDepthMs };
+        static constexpr float DepthInc { 0.01f };
+        static constexpr float DepthSkw { 1.0f };
+
+        static constexpr float DelayMin { DSP::Chorus::MinDelayMs };
+        static constexpr float DelayMax { DSP::Chorus::MaxDelayMs };
+        static constexpr float DelayInc { 0.01f };
+        static constexpr float DelaySkw { 1.0f };
+
+        static const juce::StringArray VoicesLabels { "2", "3", "4", "5", "6", "7", "8" };
+
+        static const juce::String EnabledOff { "Off" };
+        static const juce::String EnabledOn { "On" };
+    }
+
+    namespace Units
+    {
+        static const juce::String Ms { "ms" };
+        static const juce::String Hz { "Hz" };
+    }
+}
+
+class ChorusAudioProcessor : public juce::AudioProcessor
+{
+public:
+    ChorusAudioProcessor();
+    ~ChorusAudioProcessor() override;
+
+    void prepareToPlay(double sampleRate, int samplesPerBlock) override;
+    void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void releaseResources() override;
+
+    void getStateInformation (juce::MemoryBlock& destData) override;
+    void setStateInformation (const void* data, int sizeInBytes) override;
+
+    mrta::ParameterManager& getParameterManager() { return parameterManager; }
+    DSP::Meter& getMeter() { return meter; }
+
+    //==============================================================================
+    juce::AudioProcessorEditor* createEditor() override;
+    bool hasEditor() const override;
+    const juce::String getName() const override;
+    bool acceptsMidi() const override;
+    bool producesMidi() const override;
+    bool isMidiEffect() const override;
+    double getTailLengthSeconds() const override;
+    int getNumPrograms() override;
+    int getCurrentProgram() override;
+    void setCurrentProgram (int index) override;
+    const juce::String getProgramName (int index) override;
+    void changeProgramName (int index, const juce::String& newName) override;
+    //==============================================================================
+
+    static constexpr double MaxSampleRate { 192000.0 };
+
+private:
+    mrta::ParameterManager parameterManager;
+    DSP::MemoryArena delayArena;
+    DSP::Chorus chorus;
+    DSP::Ramp<float> wetRamp;
+    DSP::Ramp<float> dryRamp;
+    DSP::Meter meter;
+
+    float enabled { 1.f };
+    float mix { 0.5f };
+
+    juce::AudioBuffer<float> fxBuffer;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ChorusAudioProcessor)
+};
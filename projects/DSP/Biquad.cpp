@@ -53,28 +53,53 @@ void Biquad::process(float* const* output, const float* const* input, unsigned i
     numChannels = std::min(numChannels, allocatedChannels);
     for (unsigned int c = 0; c < numChannels; ++c)
     {
-        for (unsigned int n = 0; n < numSamples; ++n)
+        // Run each section over the whole block, keeping coefficients and states
+        // in locals, following sections process the output buffer in-place
+        const float* x { input[c] };
+        for (unsigned int s = 0; s < allocatedSections; ++s)
         {
-            float x { input[c][n] };
-            for (unsigned int s = 0; s < allocatedSections; ++s)
+            const unsigned int stateOffset { c * allocatedSections * StatesPerSection + s * StatesPerSection };
+            const unsigned int coeffOffset { s * CoeffsPerSection };
+
+            const float b0 { coeffs[coeffOffset + 0] };
+            const float b1 { coeffs[coeffOffset + 1] };
+            const float b2 { coeffs[coeffOffset + 2] };
+            const float a1 { coeffs[coeffOffset + 3] };
+            const float a2 { coeffs[coeffOffset + 4] };
+
+            float x1 { states[stateOffset + 0] };
+            float x2 { states[stateOffset + 1] };
+            float y1 { states[stateOffset + 2] };
+            float y2 { states[stateOffset + 3] };
+
+            for (unsigned int n = 0; n < numSamples; ++n)
             {
-                const unsigned int stateOffset { c * allocatedSections * StatesPerSection + s * StatesPerSection };
-                const unsigned int coeffOffset { s * CoeffsPerSection };
-
-                float acc { x * coeffs[coeffOffset + 0] }; // b0
-                acc += coeffs[coeffOffset + 1] * states[stateOffset + 0]; // b1
-                acc += coeffs[coeffOffset + 2] * states[stateOffset + 1]; // b2
-                acc -= coeffs[coeffOffset + 3] * states[stateOffset + 2]; // a1
-                acc -= coeffs[coeffOffset + 4] * states[stateOffset + 3]; // a2
-
-                states[stateOffset + 1] = states[stateOffset + 0];
-                states[stateOffset + 0] = x;
-                states[stateOffset + 3] = states[stateOffset + 2];
-                states[stateOffset + 2] = acc;
-                x = acc;
+                const float in { x[n] };
+
+                float acc { in * b0 };
+                acc += b1 * x1;
+                acc += b2 * x2;
+                acc -= a1 * y1;
+                acc -= a2 * y2;
+
+                x2 = x1;
+                x1 = in;
+                y2 = y1;
+                y1 = acc;
+                output[c][n] = acc;
             }
-            output[c][n] = x;
+
+            states[stateOffset + 0] = x1;
+            states[stateOffset + 1] = x2;
+            states[stateOffset + 2] = y1;
+            states[stateOffset + 3] = y2;
+
+            x = output[c];
         }
+
+        // No sections, pass thru
+        if (allocatedSections == 0 && output[c] != input[c])
+            std::copy(input[c], input[c] + numSamples, output[c]);
     }
 }
 
@@ -0,0 +1,152 @@
+#include "Chorus.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace DSP
+{
+
+namespace
+{
+
+// Voice start phases follow the golden ratio sequence, evenly spread for any voice count
+// so changing the number of voices never moves the phase of the running ones
+constexpr float VoicePhaseStep { 0.618034f };
+
+}
+
+Chorus::Chorus() :
+    delayLine(getDelayLineLength(sampleRate), MaxChannels),
+    delayRamp(0.05f),
+    depthRamp(0.05f),
+    gainRamp(0.05f)
+{
+}
+
+Chorus::Chorus(MemoryArena& arena) :
+    delayLine(arena, getDelayLineLength(sampleRate), MaxChannels),
+    delayRamp(0.05f),
+    depthRamp(0.05f),
+    gainRamp(0.05f)
+{
+}
+
+Chorus::~Chorus()
+{
+}
+
+void Chorus::prepare(double newSampleRate, unsigned int numChannels)
+{
+    sampleRate = newSampleRate;
+    allocatedChannels = std::min(numChannels, MaxChannels);
+
+    delayLine.prepare(getDelayLineLength(sampleRate), allocatedChannels);
+
+    for (unsigned int v = 0; v < MaxVoices; ++v)
+    {
+        lfos[v].setFrequency(rate);
+        lfos[v].prepare(sampleRate);
+
+        const float voicePhase { VoicePhaseStep * static_cast<float>(v) };
+        lfos[v].reset(voicePhase - std::floor(voicePhase));
+    }
+
+    const auto minDelaySamples { static_cast<unsigned int>(MinDelayMs * static_cast<float>(0.001 * sampleRate)) };
+    subBlockSize = std::clamp(minDelaySamples, 1u, SubBlockSize);
+
+    delayRamp.prepare(sampleRate, true, delayMs * static_cast<float>(0.001 * sampleRate));
+    depthRamp.prepare(sampleRate, true, depthMs * static_cast<float>(0.001 * sampleRate));
+    gainRamp.prepare(sampleRate, true, 1.f / std::sqrt(static_cast<float>(numVoices)));
+
+    clear();
+}
+
+void Chorus::clear()
+{
+    delayLine.clear();
+}
+
+size_t Chorus::getRequiredBytes(double maxSampleRate)
+{
+    return DelayLine::getRequiredBytes(getDelayLineLength(maxSampleRate), MaxChannels);
+}
+
+unsigned int Chorus::getDelayLineLength(double sampleRate)
+{
+    return static_cast<unsigned int>(std::ceil((MaxDelayMs + MaxDepthMs) * static_cast<float>(0.001 * sampleRate))) + 2u;
+}
+
+void Chorus::process(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples)
+{
+    // Only the channels prepared in the delay line are processed
+    numChannels = std::min(numChannels, allocatedChannels);
+
+    // Sub-blocks are not longer than the shortest voice delay,
+    // so all voices can be read before the sub-block is written
+    for (unsigned int offset = 0; offset < numSamples; offset += subBlockSize)
+    {
+        const unsigned int blockSize { std::min(subBlockSize, numSamples - offset) };
+
+        // Smoothed base delay and depth in samples
+        float* delay[1] { delayBuffer };
+        float* depth[1] { depthBuffer };
+        std::fill(delayBuffer, delayBuffer + blockSize, 0.f);
+        std::fill(depthBuffer, depthBuffer + blockSize, 1.f);
+        delayRamp.applySum(delay, 1, blockSize);
+        depthRamp.applyGain(depth, 1, blockSize);
+
+        // Voice delay times, unipolar LFO scaled by depth on top of the base delay
+        for (unsigned int v = 0; v < numVoices; ++v)
+        {
+            float* lfo[MaxChannels] { lfoBuffer[0], lfoBuffer[1] };
+            lfos[v].process(lfo, numChannels, blockSize);
+
+            for (unsigned int ch = 0; ch < numChannels; ++ch)
+                for (unsigned int n = 0; n < blockSize; ++n)
+                    voiceDelayBuffer[ch][n * numVoices + v] = delayBuffer[n] + depthBuffer[n] * (0.5f + 0.5f * lfo[ch][n]);
+        }
+
+        // Read and sum all voices of each channel
+        float* out[MaxChannels] { nullptr, nullptr };
+        const float* in[MaxChannels] { nullptr, nullptr };
+        for (unsigned int ch = 0; ch < numChannels; ++ch)
+        {
+            out[ch] = output[ch] + offset;
+            in[ch] = input[ch] + offset;
+            delayLine.readTaps(out[ch], voiceDelayBuffer[ch], numVoices, ch, blockSize);
+        }
+
+        // Write input once for all voices
+        delayLine.write(in, numChannels, blockSize);
+
+        // Keep the voice sum level steady regardless of the voice count
+        gainRamp.applyGain(out, numChannels, blockSize);
+    }
+}
+
+void Chorus::setVoices(unsigned int newNumVoices)
+{
+    numVoices = std::clamp(newNumVoices, MinVoices, MaxVoices);
+    gainRamp.setTarget(1.f / std::sqrt(static_cast<float>(numVoices)));
+}
+
+void Chorus::setRate(float rateHz)
+{
+    rate = std::fmax(rateHz, 0.f);
+    for (auto& lfo : lfos)
+        lfo.setFrequency(rate);
+}
+
+void Chorus::setDepth(float newDepthMs)
+{
+    depthMs = std::clamp(newDepthMs, 0.f, MaxDepthMs);
+    depthRamp.setTarget(depthMs * static_cast<float>(0.001 * sampleRate));
+}
+
+void Chorus::setDelay(float newDelayMs)
+{
+    delayMs = std::clamp(newDelayMs, MinDelayMs, MaxDelayMs);
+    delayRamp.setTarget(delayMs * static_cast<float>(0.001 * sampleRate));
+}
+
+}
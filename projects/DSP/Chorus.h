@@ -0,0 +1,93 @@
+#pragma once
+
+#include "DelayLine.h"
+#include "LFO.h"
+#include "MemoryArena.h"
+#include "Ramp.h"
+
+namespace DSP
+{
+
+class Chorus
+{
+public:
+    Chorus();
+
+    // Arena backed ctor, the delay buffer is sliced from the shared arena
+    Chorus(MemoryArena& arena);
+    ~Chorus();
+
+    // No copy semantics
+    Chorus(const Chorus&) = delete;
+    const Chorus& operator=(const Chorus&) = delete;
+
+    // No move semantics
+    Chorus(Chorus&&) = delete;
+    const Chorus& operator=(Chorus&&) = delete;
+
+    // Update sample rate, reallocates and clear internal buffers
+    void prepare(double sampleRate, unsigned int numChannels);
+
+    // Clear contents of internal buffer
+    void clear();
+
+    // Arena space needed when preparing up to maxSampleRate
+    static size_t getRequiredBytes(double maxSampleRate);
+
+    // Process audio, output is the sum of all voices only
+    // All voices of a channel are read from the same delay buffer in a single pass
+    // Output buffers must not alias the input ones
+    void process(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples);
+
+    // Set number of voices per channel
+    void setVoices(unsigned int numVoices);
+
+    // Set modulation rate in Hz
+    void setRate(float rateHz);
+
+    // Set modulation depth in ms
+    void setDepth(float depthMs);
+
+    // Set base delay time in ms
+    void setDelay(float delayMs);
+
+    static constexpr unsigned int MinVoices { 2 };
+    static constexpr unsigned int MaxVoices { 8 };
+    static constexpr unsigned int MaxChannels { LFO::MaxChannels };
+
+    static constexpr float MinDelayMs { 5.f };
+    static constexpr float MaxDelayMs { 30.f };
+    static constexpr float MaxDepthMs { 10.f };
+
+private:
+    double sampleRate { 48000.0 };
+    unsigned int allocatedChannels { MaxChannels };
+
+    DSP::DelayLine delayLine;
+
+    // One LFO per voice, L and R in quadrature
+    DSP::LFO lfos[MaxVoices];
+
+    DSP::Ramp<float> delayRamp;
+    DSP::Ramp<float> depthRamp;
+    DSP::Ramp<float> gainRamp;
+
+    // Scratch buffers for the sub-block processing
+    // Voice delay times are interleaved per channel, all voices of a sample contiguous
+    static constexpr unsigned int SubBlockSize { 64 };
+    float voiceDelayBuffer[MaxChannels][SubBlockSize * MaxVoices] {};
+    float lfoBuffer[MaxChannels][SubBlockSize] {};
+    float delayBuffer[SubBlockSize] {};
+    float depthBuffer[SubBlockSize] {};
+    unsigned int subBlockSize { SubBlockSize };
+
+    // Delay line length for the max delay time and depth
+    static unsigned int getDelayLineLength(double sampleRate);
+
+    unsigned int numVoices { 3 };
+    float rate { 0.8f };
+    float depthMs { 3.f };
+    float delayMs { 12.f };
+};
+
+}
@@ -9,9 +9,20 @@ namespace DSP
 Delay::Delay(float maxTimeMs, unsigned int numChannels) :
     delayLine(static_cast<unsigned int>(std::ceil(std::fmax(maxTimeMs, 1.f) * static_cast<float>(0.001 * sampleRate))), numChannels),
     filter(1),
-    preDistortionRamp(0.02f),
-    postDistortionRamp(0.02f),
-    timeRamp(0.5f),
+    saturation(Saturation::Accurate, MaxChannels),
+    preDistortionRamp(0.02f, Ramp<float>::Exponential),
+    postDistortionRamp(0.02f, Ramp<float>::Exponential),
+    wowRamp(0.02f),
+    feedbackRamp(0.02f)
+{
+}
+
+Delay::Delay(MemoryArena& arena, float maxTimeMs, unsigned int numChannels) :
+    delayLine(arena, static_cast<unsigned int>(std::ceil(std::fmax(maxTimeMs, 1.f) * static_cast<float>(0.001 * sampleRate))), numChannels),
+    filter(1),
+    saturation(Saturation::Accurate, MaxChannels),
+    preDistortionRamp(0.02f, Ramp<float>::Exponential),
+    postDistortionRamp(0.02f, Ramp<float>::Exponential),
     wowRamp(0.02f),
     feedbackRamp(0.02f)
 {
@@ -25,24 +36,30 @@ void Delay::prepare(double newSampleRate, float maxTimeMs, unsigned int numChann
 {
     sampleRate = newSampleRate;
 
-    delayLine.prepare(static_cast<unsigned int>(std::round(maxTimeMs * static_cast<float>(0.001 * sampleRate))), MaxChannels);
-    delayLine.setDelaySamples(1); // Keep at least 1 sample minimum fixed delay
+    // Sub-blocks must not be longer than the minimum delay time
+    const auto minDelaySamples { static_cast<unsigned int>(MinDelayTimeMs * static_cast<float>(0.001 * sampleRate)) };
+    subBlockSize = std::clamp(minDelaySamples, 1u, SubBlockSize);
+
+    delayLine.prepare(getDelayLineLength(sampleRate, maxTimeMs), MaxChannels);
+    delayLine.setSmoothingTime(0.5f, sampleRate);
+    delayLine.setDelay(FixedDelaySamples + delayTimeMs * static_cast<float>(sampleRate * 0.001), true);
 
     filter.setBandType(0, ParametricEqualizer::LowPass);
     filter.setBandResonance(0, static_cast<float>(M_SQRT1_2));
     filter.setBandFrequency(0, toneFrequency);
     filter.prepare(sampleRate, numChannels);
 
-    const auto distortionLin = std::pow(10.f, 0.05f * distortion);
-    preDistortionRamp.prepare(sampleRate, true, distortionLin);
-    postDistortionRamp.prepare(sampleRate, true, 2.f / distortionLin);
-    timeRamp.prepare(sampleRate, true, delayTimeMs * static_cast<float>(sampleRate * 0.001));
+    saturation.prepare(MaxChannels);
+
+    preDistortionRamp.prepare(sampleRate);
+    postDistortionRamp.prepare(sampleRate);
+    preDistortionRamp.setTargetDb(distortion, true);
+    postDistortionRamp.setTargetDb(PostDistortionGainDb - distortion, true);
     wowRamp.prepare(sampleRate, true, wow * WowDepthMax * static_cast<float>(sampleRate));
     feedbackRamp.prepare(sampleRate, true, feedback * 0.98f);
 
-    phaseState[0] = 0.f;
-    phaseState[1] = static_cast<float>(M_PI / 2.0);
-    phaseInc = static_cast<float>(2.0 * M_PI / sampleRate) * WowFreqHz;
+    lfo.setFrequency(WowFreqHz);
+    lfo.prepare(sampleRate);
 
     clear();
 }
@@ -51,64 +68,89 @@ void Delay::clear()
 {
     delayLine.clear();
     filter.clear();
+    saturation.clear();
 
     feedbackState[0] = 0.f;
     feedbackState[1] = 0.f;
 }
 
+size_t Delay::getRequiredBytes(double maxSampleRate, float maxTimeMs)
+{
+    return DelayLine::getRequiredBytes(getDelayLineLength(maxSampleRate, maxTimeMs), MaxChannels);
+}
+
+unsigned int Delay::getDelayLineLength(double sampleRate, float maxTimeMs)
+{
+    // Room for the fixed delay on top of the max time, plus the sample the interpolation reads past it
+    return static_cast<unsigned int>(std::round(maxTimeMs * static_cast<float>(0.001 * sampleRate)) + FixedDelaySamples) + 2u;
+}
+
 void Delay::process(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples)
 {
-    for (unsigned int n = 0; n < numSamples; ++n)
-    {
-        // Process LFO acording to mod type
-        float lfo[2] { 0.f, 0.f };
+    numChannels = std::min(numChannels, MaxChannels);
 
-        // squared sine modulation
-        const auto lfo_left { 0.5f + 0.5f * std::sin(phaseState[0]) };
-        const auto lfo_right { 0.5f + 0.5f * std::sin(phaseState[1]) };
-        lfo[0] = lfo_left * lfo_left;
-        lfo[1] = lfo_right * lfo_right;
+    float* mod[MaxChannels] { lfoBuffer[0], lfoBuffer[1] };
+    float* fb[MaxChannels] { feedbackBuffer[0], feedbackBuffer[1] };
+    float* y[MaxChannels] { delayBuffer[0], delayBuffer[1] };
 
-        // Increment and wrap phase states
-        phaseState[0] = std::fmod(phaseState[0] + phaseInc, static_cast<float>(2 * M_PI));
-        phaseState[1] = std::fmod(phaseState[1] + phaseInc, static_cast<float>(2 * M_PI));
+    // The delay line output of a sub-block only depends on samples written
+    // by previous sub-blocks, as long as it is not longer than the minimum delay time
+    for (unsigned int offset = 0; offset < numSamples; offset += subBlockSize)
+    {
+        const unsigned int blockSize { std::min(subBlockSize, numSamples - offset) };
+
+        // Squared sine modulation, quadrature between L and R
+        lfo.process(mod, numChannels, blockSize);
+        for (unsigned int ch = 0; ch < numChannels; ++ch)
+        {
+            for (unsigned int n = 0; n < blockSize; ++n)
+            {
+                const float lfoValue { 0.5f + 0.5f * mod[ch][n] };
+                mod[ch][n] = lfoValue * lfoValue;
+            }
+        }
 
-        // Apply wow and time ramps
-        wowRamp.applyGain(lfo, numChannels);
-        timeRamp.applySum(lfo, numChannels);
+        // Apply wow ramp, the delay line adds the smoothed delay time on top
+        wowRamp.applyGain(mod, numChannels, blockSize);
 
-        // Apply feedback ramp
-        feedbackRamp.applyGain(feedbackState, numChannels);
+        // Read the delayed signal for the whole sub-block
+        delayLine.read(y, mod, numChannels, blockSize);
 
-        // Sum feedback
-        float delayIn[2] { 0.f, 0.f };
+        // Feedback is the delay output one sample late
+        for (unsigned int ch = 0; ch < numChannels; ++ch)
+        {
+            fb[ch][0] = feedbackState[ch];
+            std::copy(y[ch], y[ch] + blockSize - 1, fb[ch] + 1);
+            feedbackState[ch] = y[ch][blockSize - 1];
+        }
+
+        // Apply feedback ramp and sum input
+        feedbackRamp.applyGain(fb, numChannels, blockSize);
         for (unsigned int ch = 0; ch < numChannels; ++ch)
-            delayIn[ch] = input[ch][n] + feedbackState[ch];
+            for (unsigned int n = 0; n < blockSize; ++n)
+                fb[ch][n] += input[ch][offset + n];
 
         // Apply distortion
-        preDistortionRamp.applyGain(delayIn, numChannels);
-        float delayInDistortion[2];
-        for (unsigned int ch = 0; ch < numChannels; ++ch)
-            delayInDistortion[ch] = std::tanh(delayIn[ch]);
-        postDistortionRamp.applyGain(delayInDistortion, numChannels);
+        preDistortionRamp.applyGain(fb, numChannels, blockSize);
+        saturation.process(fb, fb, numChannels, blockSize);
+        postDistortionRamp.applyGain(fb, numChannels, blockSize);
 
         // Apply tone filter
-        float delayInDistortionFilter[2] { 0.f, 0.f };
-        filter.process(delayInDistortionFilter, delayInDistortion, numChannels);
+        filter.process(fb, fb, numChannels, blockSize);
 
-        // Process delay
-        delayLine.process(feedbackState, delayInDistortionFilter, lfo, numChannels);
+        // Write delay input
+        delayLine.write(fb, numChannels, blockSize);
 
         // Write to output buffers
         for (unsigned int ch = 0; ch < numChannels; ++ch)
-            output[ch][n] = feedbackState[ch];
+            std::copy(y[ch], y[ch] + blockSize, output[ch] + offset);
     }
 }
 
 void Delay::setDelayTime(float newDelayMs)
 {
-    delayTimeMs = std::fmax(newDelayMs, 1.f);
-    timeRamp.setTarget(delayTimeMs * static_cast<float>(sampleRate * 0.001));
+    delayTimeMs = std::fmax(newDelayMs, MinDelayTimeMs);
+    delayLine.setDelay(FixedDelaySamples + delayTimeMs * static_cast<float>(sampleRate * 0.001));
 }
 
 void Delay::setWow(float wowNorm)
@@ -132,9 +174,23 @@ void Delay::setToneFrequency(float toneFreqHz)
 void Delay::setDistortion(float distortionDb)
 {
     distortion = std::clamp(distortionDb, 0.f, 36.f);
-    const auto distortionLin = std::pow(10.f, 0.05f * distortion);
-    preDistortionRamp.setTarget(distortionLin);
-    postDistortionRamp.setTarget(2.f / distortionLin);
+    preDistortionRamp.setTargetDb(distortion);
+    postDistortionRamp.setTargetDb(PostDistortionGainDb - distortion);
+}
+
+void Delay::setDistortionMode(Saturation::Mode mode)
+{
+    saturation.setMode(mode);
+}
+
+void Delay::setDistortionAntialiasing(bool enabled)
+{
+    saturation.setAntialiasing(enabled);
+}
+
+void Delay::setStorageFormat(DelayLine::StorageFormat format)
+{
+    delayLine.setStorageFormat(format);
 }
 
 }
\ No newline at end of file
@@ -1,8 +1,10 @@
 #pragma once
 
 #include "DelayLine.h"
+#include "LFO.h"
 #include "ParametricEqualizer.h"
 #include "Ramp.h"
+#include "Saturation.h"
 
 namespace DSP
 {
@@ -11,6 +13,9 @@ class Delay
 {
 public:
     Delay(float maxTimeMs, unsigned int numChannels);
+
+    // Arena backed ctor, the delay buffer is sliced from the shared arena
+    Delay(MemoryArena& arena, float maxTimeMs, unsigned int numChannels);
     ~Delay();
 
     // No default ctors
@@ -30,7 +35,11 @@ public:
     // Clear contents of internal buffer
     void clear();
 
+    // Arena space needed when preparing up to maxSampleRate
+    static size_t getRequiredBytes(double maxSampleRate, float maxTimeMs);
+
     // Process audio
+    // The feedback loop is computed in sub-blocks no longer than the minimum delay time
     void process(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples);
 
     // Set delay time in ms
@@ -48,23 +57,42 @@ public:
     // Set distortion in dB
     void setDistortion(float distortionDb);
 
+    // Set the tanh evaluation used by the distortion
+    void setDistortionMode(Saturation::Mode mode);
+
+    // Enable antiderivative antialiasing of the distortion, see Saturation
+    void setDistortionAntialiasing(bool enabled);
+
+    // Set the sample format of the delay buffer
+    // Compact formats add some noise, which suits the tape character
+    // This method reallocates the delay buffer and is not real-time safe
+    void setStorageFormat(DelayLine::StorageFormat format);
+
 private:
     double sampleRate { 48000.0 };
 
     DSP::DelayLine delayLine;
     DSP::ParametricEqualizer filter;
+    DSP::Saturation saturation;
+    DSP::LFO lfo;
 
     DSP::Ramp<float> preDistortionRamp;
     DSP::Ramp<float> postDistortionRamp;
-    DSP::Ramp<float> timeRamp;
     DSP::Ramp<float> wowRamp;
     DSP::Ramp<float> feedbackRamp;
 
-    float feedbackState[2] { 0.f, 0.f };
-    float phaseState[2] { 0.f, 0.f };
-    float phaseInc { 0.f };
+    static constexpr unsigned int MaxChannels { 2 };
+    static constexpr unsigned int SubBlockSize { 64 };
 
-    float delayTimeMs { 0.f };
+    // Scratch buffers for the sub-block processing
+    float lfoBuffer[MaxChannels][SubBlockSize] {};
+    float feedbackBuffer[MaxChannels][SubBlockSize] {};
+    float delayBuffer[MaxChannels][SubBlockSize] {};
+    unsigned int subBlockSize { SubBlockSize };
+
+    float feedbackState[MaxChannels] { 0.f, 0.f };
+
+    float delayTimeMs { MinDelayTimeMs };
     float feedback { 0.f };
     float wow { 0.f };
     float toneFrequency { 5000.f };
@@ -72,7 +100,16 @@ private:
 
     static constexpr float WowFreqHz { 2.f };
     static constexpr float WowDepthMax { 0.002f };
-    static constexpr float MaxChannels { 2 };
+    static constexpr float MinDelayTimeMs { 1.f };
+
+    // Keep at least 1 sample minimum fixed delay on top of the delay time
+    static constexpr float FixedDelaySamples { 1.f };
+
+    // Delay line length for the max delay time, including the fixed delay
+    static unsigned int getDelayLineLength(double sampleRate, float maxTimeMs);
+
+    // Post distortion gain is the inverse of the pre distortion gain, times 2
+    static constexpr float PostDistortionGainDb { 6.0206f };
 };
 
 }
\ No newline at end of file
@@ -1,15 +1,192 @@
 #include "DelayLine.h"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 
 namespace DSP
 {
 
-DelayLine::DelayLine(unsigned int maxLengthSamples, unsigned int numChannels)
+namespace
 {
-    for (unsigned int ch = 0; ch < numChannels; ++ch)
-        delayBuffer.emplace_back(maxLengthSamples, 0.f);
+
+// Gain applied before quantising to the fixed point formats
+// Full scale of the stored signal is +12dBFS
+constexpr float FixedPointHeadroom { 4.f };
+
+// Lossless storage
+struct Float32Codec
+{
+    using Storage = float;
+
+    static void encode(Storage* dst, const float* src, unsigned int numSamples)
+    {
+        std::copy(src, src + numSamples, dst);
+    }
+
+    static void decode(float* dst, const Storage* src, unsigned int numSamples)
+    {
+        std::copy(src, src + numSamples, dst);
+    }
+
+    static Storage encode(float x) { return x; }
+    static float decode(Storage x) { return x; }
+};
+
+// 16 bit fixed point with headroom
+struct Int16Codec
+{
+    using Storage = int16_t;
+
+    static constexpr float EncodeGain { 32767.f / FixedPointHeadroom };
+    static constexpr float DecodeGain { FixedPointHeadroom / 32767.f };
+
+    static void encode(Storage* dst, const float* src, unsigned int numSamples)
+    {
+        for (unsigned int n = 0; n < numSamples; ++n)
+            dst[n] = encode(src[n]);
+    }
+
+    static void decode(float* dst, const Storage* src, unsigned int numSamples)
+    {
+        for (unsigned int n = 0; n < numSamples; ++n)
+            dst[n] = decode(src[n]);
+    }
+
+    static Storage encode(float x)
+    {
+        return static_cast<Storage>(std::lrint(std::clamp(x * EncodeGain, -32767.f, 32767.f)));
+    }
+
+    static float decode(Storage x) { return static_cast<float>(x) * DecodeGain; }
+};
+
+// Upper half of a IEEE 754 float, rounded to nearest even
+struct BFloat16Codec
+{
+    using Storage = uint16_t;
+
+    static void encode(Storage* dst, const float* src, unsigned int numSamples)
+    {
+        for (unsigned int n = 0; n < numSamples; ++n)
+            dst[n] = encode(src[n]);
+    }
+
+    static void decode(float* dst, const Storage* src, unsigned int numSamples)
+    {
+        for (unsigned int n = 0; n < numSamples; ++n)
+            dst[n] = decode(src[n]);
+    }
+
+    static Storage encode(float x)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        bits += 0x7FFFu + ((bits >> 16) & 1u);
+        return static_cast<Storage>(bits >> 16);
+    }
+
+    static float decode(Storage x)
+    {
+        const uint32_t bits { static_cast<uint32_t>(x) << 16 };
+        float y;
+        std::memcpy(&y, &bits, sizeof(y));
+        return y;
+    }
+};
+
+constexpr int MuLawBias { 0x84 };
+
+// Segment (exponent) lookup, indexed by the 8 MSBs of the biased magnitude
+constexpr std::array<uint8_t, 256> makeMuLawExponentTable()
+{
+    std::array<uint8_t, 256> table {};
+    for (int i = 2; i < 256; ++i)
+        table[static_cast<size_t>(i)] = static_cast<uint8_t>(table[static_cast<size_t>(i / 2)] + 1);
+    return table;
+}
+
+// Decoded value of every code word, already scaled back to float
+constexpr std::array<float, 256> makeMuLawDecodeTable()
+{
+    std::array<float, 256> table {};
+    for (int i = 0; i < 256; ++i)
+    {
+        const int u { ~i & 0xFF };
+        const int exponent { (u >> 4) & 0x07 };
+        const int mantissa { u & 0x0F };
+        const int magnitude { (((mantissa << 3) + MuLawBias) << exponent) - MuLawBias };
+        const float value { static_cast<float>(magnitude) * (FixedPointHeadroom / 32767.f) };
+        table[static_cast<size_t>(i)] = (u & 0x80) ? -value : value;
+    }
+    return table;
+}
+
+// G.711 mu-law, 14 bit dynamic range companded into 8 bits
+struct MuLaw8Codec
+{
+    using Storage = uint8_t;
+
+    static constexpr int Clip { 32635 };
+    static constexpr float EncodeGain { 32767.f / FixedPointHeadroom };
+
+    static constexpr std::array<uint8_t, 256> ExponentTable { makeMuLawExponentTable() };
+    static constexpr std::array<float, 256> DecodeTable { makeMuLawDecodeTable() };
+
+    static void encode(Storage* dst, const float* src, unsigned int numSamples)
+    {
+        for (unsigned int n = 0; n < numSamples; ++n)
+            dst[n] = encode(src[n]);
+    }
+
+    static void decode(float* dst, const Storage* src, unsigned int numSamples)
+    {
+        for (unsigned int n = 0; n < numSamples; ++n)
+            dst[n] = decode(src[n]);
+    }
+
+    static Storage encode(float x)
+    {
+        const int pcm { static_cast<int>(std::lrint(std::clamp(x * EncodeGain, -32767.f, 32767.f))) };
+        const int sign { pcm < 0 ? 0x80 : 0x00 };
+        const int magnitude { std::min(pcm < 0 ? -pcm : pcm, Clip) + MuLawBias };
+        const int exponent { ExponentTable[static_cast<size_t>((magnitude >> 7) & 0xFF)] };
+        const int mantissa { (magnitude >> (exponent + 3)) & 0x0F };
+        return static_cast<Storage>(~(sign | (exponent << 4) | mantissa));
+    }
+
+    static float decode(Storage x) { return DecodeTable[x]; }
+};
+
+// Call the functor with the codec matching the storage format
+template<typename Fn>
+void dispatchCodec(DelayLine::StorageFormat format, Fn&& fn)
+{
+    switch (format)
+    {
+    case DelayLine::Float32: fn(Float32Codec {}); break;
+    case DelayLine::Int16: fn(Int16Codec {}); break;
+    case DelayLine::BFloat16: fn(BFloat16Codec {}); break;
+    case DelayLine::MuLaw8: fn(MuLaw8Codec {}); break;
+    default: break;
+    }
+}
+
+}
+
+DelayLine::DelayLine(unsigned int maxLengthSamples, unsigned int numChannels, StorageFormat newFormat) :
+    format { newFormat }
+{
+    prepare(maxLengthSamples, numChannels);
+}
+
+DelayLine::DelayLine(MemoryArena& newArena, unsigned int maxLengthSamples, unsigned int numChannels, StorageFormat newFormat) :
+    format { newFormat },
+    arena { &newArena }
+{
+    prepare(maxLengthSamples, numChannels);
 }
 
 DelayLine::~DelayLine()
@@ -18,149 +195,465 @@ DelayLine::~DelayLine()
 
 void DelayLine::clear()
 {
-    for (auto& b : delayBuffer)
-        std::fill(b.begin(), b.end(), 0.f);
+    // All zero bits decode to silence, except for mu-law where silence is 0xFF
+    const unsigned char silence { format == MuLaw8 ? static_cast<unsigned char>(0xFF) : static_cast<unsigned char>(0x00) };
+    std::fill(data, data + dataBytes, silence);
 }
 
 void DelayLine::prepare(unsigned int maxLengthSamples, unsigned int numChannels)
 {
-    delayBuffer.clear();
-    for (unsigned int ch = 0; ch < numChannels; ++ch)
-        delayBuffer.emplace_back(maxLengthSamples, 0.f);
+    bufferSize = std::max(maxLengthSamples, 2u);
+    allocatedChannels = numChannels;
+    dataBytes = static_cast<size_t>(bufferSize) * allocatedChannels * getBytesPerSample(format);
+
+    data = arena != nullptr ? arena->allocate(dataBytes) : nullptr;
+    arenaSliceBytes = data != nullptr ? dataBytes : 0;
+    if (data == nullptr)
+    {
+        storage.resize(dataBytes);
+        data = storage.data();
+    }
+
+    writeIndex = 0;
+    clear();
 }
 
 void DelayLine::process(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples)
 {
-    const unsigned int delayBufferSize { static_cast<unsigned int>(delayBuffer[0].size()) };
+    dispatchCodec(format, [&] (auto codec)
+    {
+        processFixed<decltype(codec)>(output, input, numChannels, numSamples);
+    });
+}
+
+void DelayLine::process(float* output, const float* input, unsigned int numChannels)
+{
+    dispatchCodec(format, [&] (auto codec)
+    {
+        processFixed<decltype(codec)>(output, input, numChannels);
+    });
+}
 
-    numChannels = std::min(numChannels, static_cast<unsigned int>(delayBuffer.size()));
-    for (unsigned int ch = 0; ch < numChannels; ++ch)
+void DelayLine::process(float* const* audioOutput, const float* const* audioInput, const float* const* modInput, unsigned int numChannels, unsigned int numSamples)
+{
+    dispatchCodec(format, [&] (auto codec)
     {
-        unsigned int workingWriteIndex { writeIndex };
-        unsigned int workingReadIndex { (workingWriteIndex + delayBufferSize - delaySamples) % delayBufferSize };
+        processModulated<decltype(codec)>(audioOutput, audioInput, modInput, numChannels, numSamples);
+    });
+}
 
-        for (unsigned int n = 0; n < numSamples; ++n)
-        {
-            const float x { input[ch][n] };
-            output[ch][n] = delayBuffer[ch][workingReadIndex];
-            delayBuffer[ch][workingWriteIndex] = x;
+void DelayLine::process(float* audioOutput, const float* audioInput, const float* modInput, unsigned int numChannels)
+{
+    dispatchCodec(format, [&] (auto codec)
+    {
+        processModulated<decltype(codec)>(audioOutput, audioInput, modInput, numChannels);
+    });
+}
 
-            ++workingWriteIndex; workingWriteIndex %= delayBufferSize;
-            ++workingReadIndex; workingReadIndex %= delayBufferSize;
-        }
+void DelayLine::read(float* const* audioOutput, const float* const* modInput, unsigned int numChannels, unsigned int numSamples)
+{
+    dispatchCodec(format, [&] (auto codec)
+    {
+        readInterpolated<decltype(codec)>(audioOutput, modInput, numChannels, numSamples);
+    });
+}
+
+void DelayLine::readTaps(float* audioOutput, const float* tapDelays, unsigned int numTaps, unsigned int channel, unsigned int numSamples)
+{
+    // No delayed signal on a channel that was not prepared
+    if (channel >= allocatedChannels)
+    {
+        std::fill(audioOutput, audioOutput + numSamples, 0.f);
+        return;
     }
 
-    writeIndex += numSamples; writeIndex %= delayBufferSize;
+    dispatchCodec(format, [&] (auto codec)
+    {
+        readTapsInterpolated<decltype(codec)>(audioOutput, tapDelays, numTaps, channel, numSamples);
+    });
 }
 
-void DelayLine::process(float* output, const float* input, unsigned int numChannels)
+void DelayLine::write(const float* const* audioInput, unsigned int numChannels, unsigned int numSamples)
 {
-    const unsigned int delayBufferSize{ static_cast<unsigned int>(delayBuffer[0].size()) };
+    dispatchCodec(format, [&] (auto codec)
+    {
+        writeBlock<decltype(codec)>(audioInput, numChannels, numSamples);
+    });
+}
 
-    numChannels = std::min(numChannels, static_cast<unsigned int>(delayBuffer.size()));
+void DelayLine::setDelaySamples(unsigned int newDelaySamples)
+{
+    currentDelay = targetDelay = static_cast<float>(std::max(std::min(newDelaySamples, bufferSize - 1u), 1u));
+    delayRampRemaining = 0;
+}
+
+void DelayLine::setDelay(float newDelaySamples, bool skipSmoothing)
+{
+    targetDelay = std::clamp(newDelaySamples, 1.f, static_cast<float>(bufferSize - 2u));
+
+    if (skipSmoothing || smoothingSamples == 0)
+    {
+        currentDelay = targetDelay;
+        delayRampRemaining = 0;
+    }
+    else
+    {
+        delayRampOrigin = currentDelay;
+        delayRampLength = smoothingSamples;
+        delayRampRemaining = smoothingSamples;
+        delayStep = (targetDelay - currentDelay) / static_cast<float>(smoothingSamples);
+    }
+}
+
+void DelayLine::setSmoothingTime(float timeSec, double sampleRate)
+{
+    smoothingSamples = static_cast<unsigned int>(std::round(std::fmax(timeSec, 0.f) * static_cast<float>(sampleRate)));
+}
+
+void DelayLine::setSmoothingMode(SmoothingMode newMode)
+{
+    smoothingMode = newMode;
+}
+
+void DelayLine::setStorageFormat(StorageFormat newFormat)
+{
+    if (newFormat == format)
+        return;
+
+    format = newFormat;
+
+    // Formats no larger than the one the arena slice was taken for fit in it,
+    // taking a new slice would abandon the current one and overflow an exactly sized arena
+    const size_t newDataBytes { static_cast<size_t>(bufferSize) * allocatedChannels * getBytesPerSample(format) };
+    if (newDataBytes <= arenaSliceBytes)
+    {
+        dataBytes = newDataBytes;
+        writeIndex = 0;
+        clear();
+        return;
+    }
+
+    prepare(bufferSize, allocatedChannels);
+}
+
+size_t DelayLine::getBytesPerSample(StorageFormat format)
+{
+    size_t bytes { 0 };
+    dispatchCodec(format, [&bytes] (auto codec)
+    {
+        bytes = sizeof(typename decltype(codec)::Storage);
+    });
+    return bytes;
+}
+
+size_t DelayLine::getRequiredBytes(unsigned int maxLengthSamples, unsigned int numChannels, StorageFormat format)
+{
+    return MemoryArena::getAlignedSize(static_cast<size_t>(std::max(maxLengthSamples, 2u)) * numChannels * getBytesPerSample(format));
+}
+
+template<typename Codec>
+typename Codec::Storage* DelayLine::getChannel(unsigned int channel)
+{
+    return reinterpret_cast<typename Codec::Storage*>(data) + static_cast<size_t>(channel) * bufferSize;
+}
 
-    unsigned int workingWriteIndex { writeIndex };
-    unsigned int workingReadIndex { (workingWriteIndex + delayBufferSize - delaySamples) % delayBufferSize };
+template<typename Codec>
+void DelayLine::processFixed(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples)
+{
+    // Gliding or fractional delay times need interpolated reads
+    if (delayRampRemaining > 0 || currentDelay != std::floor(currentDelay))
+    {
+        processInterpolated<Codec>(output, input, nullptr, numChannels, numSamples);
+        return;
+    }
+
+    const unsigned int delaySamples { static_cast<unsigned int>(currentDelay) };
 
+    numChannels = std::min(numChannels, allocatedChannels);
     for (unsigned int ch = 0; ch < numChannels; ++ch)
     {
-        const float x { input[ch] };
-        output[ch] = delayBuffer[ch][workingReadIndex];
-        delayBuffer[ch][workingWriteIndex] = x;
+        auto* delayBuffer { getChannel<Codec>(ch) };
+
+        unsigned int workingWriteIndex { writeIndex };
+        unsigned int workingReadIndex { (workingWriteIndex + bufferSize - delaySamples) % bufferSize };
+
+        // Process in contiguous chunks no longer than the delay time,
+        // so reads never see samples written on the same chunk
+        const unsigned int maxChunk { delaySamples > 0 ? delaySamples : bufferSize };
+        unsigned int n { 0 };
+        while (n < numSamples)
+        {
+            const unsigned int chunk { std::min({ numSamples - n, maxChunk,
+                                                  bufferSize - workingReadIndex, bufferSize - workingWriteIndex }) };
+
+            Codec::decode(output[ch] + n, delayBuffer + workingReadIndex, chunk);
+            Codec::encode(delayBuffer + workingWriteIndex, input[ch] + n, chunk);
+
+            n += chunk;
+            workingWriteIndex += chunk; workingWriteIndex %= bufferSize;
+            workingReadIndex += chunk; workingReadIndex %= bufferSize;
+        }
     }
 
-    ++writeIndex; writeIndex %= delayBufferSize;
+    writeIndex += numSamples; writeIndex %= bufferSize;
 }
 
-void DelayLine::process(float* const* audioOutput, const float* const* audioInput, const float* const* modInput, unsigned int numChannels, unsigned int numSamples)
+template<typename Codec>
+void DelayLine::processFixed(float* output, const float* input, unsigned int numChannels)
+{
+    float* const outputs[] { output };
+    const float* const inputs[] { input };
+    processFrame<Codec>(outputs, inputs, nullptr, numChannels);
+}
+
+template<typename Codec>
+void DelayLine::processModulated(float* const* audioOutput, const float* const* audioInput, const float* const* modInput, unsigned int numChannels, unsigned int numSamples)
+{
+    processInterpolated<Codec>(audioOutput, audioInput, modInput, numChannels, numSamples);
+}
+
+template<typename Codec>
+void DelayLine::processModulated(float* audioOutput, const float* audioInput, const float* modInput, unsigned int numChannels)
+{
+    float* const outputs[] { audioOutput };
+    const float* const inputs[] { audioInput };
+    const float* const mods[] { modInput };
+    processFrame<Codec>(outputs, inputs, mods, numChannels);
+}
+
+template<typename Codec>
+void DelayLine::processInterpolated(float* const* audioOutput, const float* const* audioInput, const float* const* modInput, unsigned int numChannels, unsigned int numSamples)
 {
-    const unsigned int delayBufferSize{ static_cast<unsigned int>(delayBuffer[0].size()) };
+    // Base delay time trajectory over this block
+    const auto trajectory { getDelayTrajectory(numSamples) };
 
-    numChannels = std::min(numChannels, static_cast<unsigned int>(delayBuffer.size()));
+    const float minDelay { 1.f };
+    const float maxDelay { static_cast<float>(bufferSize - 2u) };
+
+    numChannels = std::min(numChannels, allocatedChannels);
     for (unsigned int ch = 0; ch < numChannels; ++ch)
     {
-        // Calculate base indices based on fixed delay time
+        auto* delayBuffer { getChannel<Codec>(ch) };
         unsigned int workingWriteIndex { writeIndex };
-        unsigned int workingReadIndex { (workingWriteIndex + delayBufferSize - delaySamples) % delayBufferSize };
 
         for (unsigned int n = 0; n < numSamples; ++n)
         {
+            // Total delay time, base plus optional modulation
+            float d { trajectory.at(n) };
+            if (modInput != nullptr)
+                d += std::fmax(modInput[ch][n], 0.f);
+            d = std::clamp(d, minDelay, maxDelay);
+
             // Linear interpolation coefficients
-            const float m { std::fmax(modInput[ch][n], 0.f) };
-            const float mFloor { std::floor(m) };
-            const float mFrac0 { m - mFloor };
-            const float mFrac1 { 1.f - mFrac0 };
+            const float dFloor { std::floor(d) };
+            const float dFrac0 { d - dFloor };
+            const float dFrac1 { 1.f - dFrac0 };
 
             // Calculate read indices
-            const unsigned int readIndex0 { (workingReadIndex + delayBufferSize - static_cast<unsigned int>(mFloor)) % delayBufferSize };
-            const unsigned int readIndex1 { (readIndex0 + delayBufferSize - 1u) % delayBufferSize };
+            const unsigned int readIndex0 { (workingWriteIndex + bufferSize - static_cast<unsigned int>(dFloor)) % bufferSize };
+            const unsigned int readIndex1 { (readIndex0 + bufferSize - 1u) % bufferSize };
 
             // Read from delay line
-            const float read0 = delayBuffer[ch][readIndex0];
-            const float read1 = delayBuffer[ch][readIndex1];
+            const float read0 { Codec::decode(delayBuffer[readIndex0]) };
+            const float read1 { Codec::decode(delayBuffer[readIndex1]) };
 
             // Read audio input
             const float x { audioInput[ch][n] };
 
             // Interpolate output
-            audioOutput[ch][n] = read0 * mFrac1 + read1 * mFrac0;
+            audioOutput[ch][n] = read0 * dFrac1 + read1 * dFrac0;
 
             // Write input
-            delayBuffer[ch][workingWriteIndex] = x;
+            delayBuffer[workingWriteIndex] = Codec::encode(x);
 
-            // Increament indices
-            ++workingWriteIndex; workingWriteIndex %= delayBufferSize;
-            ++workingReadIndex; workingReadIndex %= delayBufferSize;
+            // Increament write index
+            ++workingWriteIndex; workingWriteIndex %= bufferSize;
         }
     }
 
-    // Update persistent write index
-    writeIndex += numSamples; writeIndex %= delayBufferSize;
+    // Update persistent write index and delay time
+    writeIndex += numSamples; writeIndex %= bufferSize;
+    advanceDelay(numSamples);
 }
 
-void DelayLine::process(float* audioOutput, const float* audioInput, const float* modInput, unsigned int numChannels)
+template<typename Codec>
+void DelayLine::readInterpolated(float* const* audioOutput, const float* const* modInput, unsigned int numChannels, unsigned int numSamples)
+{
+    // Base delay time trajectory over this block
+    const auto trajectory { getDelayTrajectory(numSamples) };
+
+    const float minDelay { 1.f };
+    const float maxDelay { static_cast<float>(bufferSize - 2u) };
+
+    numChannels = std::min(numChannels, allocatedChannels);
+    for (unsigned int ch = 0; ch < numChannels; ++ch)
+    {
+        const auto* delayBuffer { getChannel<Codec>(ch) };
+
+        // Read positions are taken relative to a virtual write index
+        // that is bufferSize ahead, so no wrap around is needed before the modulo
+        for (unsigned int n = 0; n < numSamples; ++n)
+        {
+            float d { trajectory.at(n) };
+            if (modInput != nullptr)
+                d += std::fmax(modInput[ch][n], 0.f);
+            d = std::clamp(d, minDelay, maxDelay);
+
+            const float dFloor { std::floor(d) };
+            const float dFrac0 { d - dFloor };
+
+            const unsigned int readIndex0 { (writeIndex + n + bufferSize - static_cast<unsigned int>(dFloor)) % bufferSize };
+            const unsigned int readIndex1 { (readIndex0 + bufferSize - 1u) % bufferSize };
+
+            const float read0 { Codec::decode(delayBuffer[readIndex0]) };
+            const float read1 { Codec::decode(delayBuffer[readIndex1]) };
+
+            audioOutput[ch][n] = read0 * (1.f - dFrac0) + read1 * dFrac0;
+        }
+    }
+}
+
+template<typename Codec>
+void DelayLine::readTapsInterpolated(float* audioOutput, const float* tapDelays, unsigned int numTaps, unsigned int channel, unsigned int numSamples)
+{
+    const float minDelay { 1.f };
+    const float maxDelay { static_cast<float>(bufferSize - 2u) };
+    const int size { static_cast<int>(bufferSize) };
+    const auto* delayBuffer { getChannel<Codec>(channel) };
+
+    // All taps of a sample are summed together, so the buffer is swept once per block
+    // The taps are the contiguous inner loop, which vectorises as gathers
+    int baseIndex { static_cast<int>(writeIndex) };
+    for (unsigned int n = 0; n < numSamples; ++n)
+    {
+        const float* delays { tapDelays + n * numTaps };
+
+        float sum { 0.f };
+        for (unsigned int t = 0; t < numTaps; ++t)
+        {
+            const float d { std::clamp(delays[t], minDelay, maxDelay) };
+            const int dInt { static_cast<int>(d) };
+            const float dFrac0 { d - static_cast<float>(dInt) };
+
+            // Delays are within the buffer, a single conditional wrap per index is enough
+            int readIndex0 { baseIndex - dInt };
+            readIndex0 += readIndex0 < 0 ? size : 0;
+            int readIndex1 { readIndex0 - 1 };
+            readIndex1 += readIndex1 < 0 ? size : 0;
+
+            const float read0 { Codec::decode(delayBuffer[readIndex0]) };
+            const float read1 { Codec::decode(delayBuffer[readIndex1]) };
+
+            sum += read0 * (1.f - dFrac0) + read1 * dFrac0;
+        }
+
+        audioOutput[n] = sum;
+        baseIndex = baseIndex + 1 == size ? 0 : baseIndex + 1;
+    }
+}
+
+template<typename Codec>
+void DelayLine::writeBlock(const float* const* audioInput, unsigned int numChannels, unsigned int numSamples)
 {
-    const unsigned int delayBufferSize{ static_cast<unsigned int>(delayBuffer[0].size()) };
+    numChannels = std::min(numChannels, allocatedChannels);
+    for (unsigned int ch = 0; ch < numChannels; ++ch)
+    {
+        auto* delayBuffer { getChannel<Codec>(ch) };
+
+        // Encode in at most two contiguous chunks, before and after the wrap around
+        unsigned int workingWriteIndex { writeIndex };
+        unsigned int n { 0 };
+        while (n < numSamples)
+        {
+            const unsigned int chunk { std::min(numSamples - n, bufferSize - workingWriteIndex) };
+            Codec::encode(delayBuffer + workingWriteIndex, audioInput[ch] + n, chunk);
+
+            n += chunk;
+            workingWriteIndex += chunk; workingWriteIndex %= bufferSize;
+        }
+    }
 
-    // Calculate base indices based on fixed delay time
-    unsigned int workingWriteIndex { writeIndex };
-    unsigned int workingReadIndex { (workingWriteIndex + delayBufferSize - delaySamples) % delayBufferSize };
+    // Update persistent write index and delay time
+    writeIndex += numSamples; writeIndex %= bufferSize;
+    advanceDelay(numSamples);
+}
+
+template<typename Codec>
+void DelayLine::processFrame(float* const* audioOutput, const float* const* audioInput, const float* const* modInput, unsigned int numChannels)
+{
+    // Single sample flavour, the channels are stored in the first (and only) pointer
+    const float d0 { getDelayTrajectory(1).at(0) };
+    const float minDelay { 1.f };
+    const float maxDelay { static_cast<float>(bufferSize - 2u) };
 
-    numChannels = std::min(numChannels, static_cast<unsigned int>(delayBuffer.size()));
+    numChannels = std::min(numChannels, allocatedChannels);
     for (unsigned int ch = 0; ch < numChannels; ++ch)
     {
+        auto* delayBuffer { getChannel<Codec>(ch) };
+
+        // Total delay time, base plus optional modulation
+        float d { d0 };
+        if (modInput != nullptr)
+            d += std::fmax(modInput[0][ch], 0.f);
+        d = std::clamp(d, minDelay, maxDelay);
+
         // Linear interpolation coefficients
-        const float m { std::fmax(modInput[ch], 0.f) };
-        const float mFloor { std::floor(m) };
-        const float mFrac0 { m - mFloor };
-        const float mFrac1 { 1.f - mFrac0 };
+        const float dFloor { std::floor(d) };
+        const float dFrac0 { d - dFloor };
+        const float dFrac1 { 1.f - dFrac0 };
 
         // Calculate read indeces
-        const unsigned int readIndex0 { (workingReadIndex + delayBufferSize - static_cast<unsigned int>(mFloor)) % delayBufferSize };
-        const unsigned int readIndex1 { (readIndex0 + delayBufferSize - 1u) % delayBufferSize };
+        const unsigned int readIndex0 { (writeIndex + bufferSize - static_cast<unsigned int>(dFloor)) % bufferSize };
+        const unsigned int readIndex1 { (readIndex0 + bufferSize - 1u) % bufferSize };
 
         // Read from delay line
-        const float read0 = delayBuffer[ch][readIndex0];
-        const float read1 = delayBuffer[ch][readIndex1];
+        const float read0 { Codec::decode(delayBuffer[readIndex0]) };
+        const float read1 { Codec::decode(delayBuffer[readIndex1]) };
 
         // Read audio input
-        const float x { audioInput[ch] };
+        const float x { audioInput[0][ch] };
 
         // Interpolate output
-        audioOutput[ch] = read0 * mFrac1 + read1 * mFrac0;
+        audioOutput[0][ch] = read0 * dFrac1 + read1 * dFrac0;
 
         // Write input
-        delayBuffer[ch][workingWriteIndex] = x;
+        delayBuffer[writeIndex] = Codec::encode(x);
     }
 
-    // Update persistent write index
-    ++writeIndex; writeIndex %= delayBufferSize;
+    // Update persistent write index and delay time
+    ++writeIndex; writeIndex %= bufferSize;
+    advanceDelay(1);
 }
 
-void DelayLine::setDelaySamples(unsigned int newDelaySamples)
+DelayLine::DelayTrajectory DelayLine::getDelayTrajectory(unsigned int numSamples) const
 {
-    delaySamples = std::max(std::min(newDelaySamples, static_cast<unsigned int>(delayBuffer[0].size() - 1u)), 1u);
+    // Steady delay time
+    if (delayRampRemaining == 0)
+        return { currentDelay, 0.f, 0u, numSamples };
+
+    const unsigned int elapsed { delayRampLength - delayRampRemaining };
+    if (smoothingMode == BlockRate)
+    {
+        // Glide sampled at the block end, interpolated over the block
+        const float end { numSamples < delayRampRemaining ? delayRampOrigin + delayStep * static_cast<float>(elapsed + numSamples) : targetDelay };
+        return { currentDelay, (end - currentDelay) / static_cast<float>(std::max(numSamples, 1u)), 0u, numSamples };
+    }
+
+    return { delayRampOrigin, delayStep, elapsed, delayRampRemaining };
 }
 
+void DelayLine::advanceDelay(unsigned int numSamples)
+{
+    if (delayRampRemaining > numSamples)
+    {
+        delayRampRemaining -= numSamples;
+        currentDelay = delayRampOrigin + delayStep * static_cast<float>(delayRampLength - delayRampRemaining);
+    }
+    else
+    {
+        currentDelay = targetDelay;
+        delayRampRemaining = 0;
+    }
+}
 
-}
\ No newline at end of file
+}
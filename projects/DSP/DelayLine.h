@@ -1,14 +1,39 @@
 #pragma once
 
+#include <cstddef>
 #include <vector>
 
+#include "MemoryArena.h"
+
 namespace DSP
 {
 
 class DelayLine
 {
 public:
-    DelayLine(unsigned int maxLengthSamples, unsigned int numChannels);
+    // Sample format used to store the delay buffer
+    // The compact formats trade noise floor for memory footprint,
+    // which pays off for very long delay buffers
+    enum StorageFormat : unsigned int
+    {
+        Float32 = 0, // 4 bytes per sample, lossless
+        Int16,       // 2 bytes per sample, fixed point with 12dB of headroom
+        BFloat16,    // 2 bytes per sample, truncated float with 8 bits of mantissa
+        MuLaw8       // 1 byte per sample, G.711 mu-law companding with 12dB of headroom
+    };
+
+    // Evaluation rate of the delay time smoothing
+    enum SmoothingMode : unsigned int
+    {
+        PerSample = 0, // exact linear glide, evaluated every sample
+        BlockRate      // glide evaluated once per process call and linearly interpolated over the block
+    };
+
+    DelayLine(unsigned int maxLengthSamples, unsigned int numChannels, StorageFormat format = Float32);
+
+    // Arena backed ctor, the delay buffer is sliced from the arena on every prepare call
+    // If the arena runs out of space the delay line falls back to its own heap storage
+    DelayLine(MemoryArena& arena, unsigned int maxLengthSamples, unsigned int numChannels, StorageFormat format = Float32);
     ~DelayLine();
 
     // No default ctor
@@ -26,9 +51,13 @@ public:
     void clear();
 
     // Reallocate delay buffer for the new channel count and clear its contents
+    // When backed by an arena this only takes a new slice from it, so the arena
+    // should be reset before preparing all the delay lines sharing it
     void prepare(unsigned int maxLengthSamples, unsigned int numChannels);
 
-    // Process audio with the currently (fixed) set delay time
+    // Process audio with the currently set delay time
+    // Integer and steady delay times take a plain copy path,
+    // fractional or gliding ones use linear interpolation
     void process(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples);
 
     // Single sample flavour of the fixed delay time processing
@@ -36,7 +65,7 @@ public:
 
     // Process audio thru the delay line with audio rate modulation
     // The modulation input is a audio rate signal with the time modulation in samples
-    // on top of the currently set delay time
+    // on top of the currently set (and smoothed) delay time
     // The modulation input supports fractional values and uses linear interpolation
     void process(float* const* audioOutput, const float* const* audioInput, const float* const* modInput,
                  unsigned int numChannels, unsigned int numSamples);
@@ -44,13 +73,123 @@ public:
     // Single sample flavour of the modulated delay time processing
     void process(float* audioOutput, const float* audioInput, const float* modInput, unsigned int numChannels);
 
-    // Set the current delay time in samples
+    // Split read/write flavour, meant for feedback loops computed a block at a time
+    // Read a block of delayed audio, with optional modulation input (can be nullptr),
+    // then write the same block size to advance the delay line
+    // The block must not be longer than the shortest delay time used in it,
+    // otherwise the read would need samples not yet written
+    void read(float* const* audioOutput, const float* const* modInput, unsigned int numChannels, unsigned int numSamples);
+    void write(const float* const* audioInput, unsigned int numChannels, unsigned int numSamples);
+
+    // Read and sum several interpolated taps of a single channel, meant for multi-voice effects
+    // Tap delays are absolute times in samples, interleaved with numTaps values per sample,
+    // the base delay time is not applied
+    // Same block length restriction as read, against the shortest tap delay
+    void readTaps(float* audioOutput, const float* tapDelays, unsigned int numTaps, unsigned int channel, unsigned int numSamples);
+
+    // Set the current delay time in samples, skipping the smoothing
     void setDelaySamples(unsigned int samples);
 
+    // Set the delay time in samples, supporting fractional values
+    // Changes glide linearly over the smoothing time, unless skipped
+    void setDelay(float delaySamples, bool skipSmoothing = false);
+
+    // Set the glide time used by setDelay, no smoothing by default
+    void setSmoothingTime(float timeSec, double sampleRate);
+
+    // Set how often the delay time glide is evaluated
+    void setSmoothingMode(SmoothingMode mode);
+
+    // Change the storage format and clear the delay buffer
+    // An arena slice is reused in place when the new format fits in it, otherwise the buffer
+    // is reallocated, in which case this method is not real-time safe
+    void setStorageFormat(StorageFormat newFormat);
+
+    StorageFormat getStorageFormat() const noexcept { return format; }
+
+    // Size in bytes of a single stored sample for a given format
+    static size_t getBytesPerSample(StorageFormat format);
+
+    // Arena space needed to hold a delay buffer
+    static size_t getRequiredBytes(unsigned int maxLengthSamples, unsigned int numChannels, StorageFormat format = Float32);
+
 private:
-    std::vector<std::vector<float>> delayBuffer;
-    unsigned int delaySamples { 0 };
+    StorageFormat format { Float32 };
+
+    // Optional shared arena
+    MemoryArena* arena { nullptr };
+
+    // Raw storage of all channels, each channel is bufferSize samples long
+    // Points to either an arena slice or the owned heap storage
+    unsigned char* data { nullptr };
+    size_t dataBytes { 0 };
+    size_t arenaSliceBytes { 0 }; // size of the arena slice held, 0 when on the heap
+    std::vector<unsigned char> storage;
+    unsigned int bufferSize { 0 };
+    unsigned int allocatedChannels { 0 };
+
     unsigned int writeIndex { 0 };
+
+    // Delay time in samples and its linear glide state
+    float currentDelay { 0.f };
+    float targetDelay { 0.f };
+    float delayStep { 0.f };
+    float delayRampOrigin { 0.f };
+    unsigned int delayRampLength { 0 };
+    unsigned int delayRampRemaining { 0 };
+    unsigned int smoothingSamples { 0 };
+    SmoothingMode smoothingMode { PerSample };
+
+    // Base delay time over a block, evaluated from the glide origin
+    // so the result does not depend on how the glide is split into blocks
+    struct DelayTrajectory
+    {
+        float origin;
+        float increment;
+        unsigned int offset;
+        unsigned int limit;
+
+        float at(unsigned int n) const noexcept
+        {
+            return origin + increment * static_cast<float>(offset + (n + 1u < limit ? n + 1u : limit));
+        }
+    };
+
+    DelayTrajectory getDelayTrajectory(unsigned int numSamples) const;
+    void advanceDelay(unsigned int numSamples);
+
+    template<typename Codec>
+    typename Codec::Storage* getChannel(unsigned int channel);
+
+    template<typename Codec>
+    void processFixed(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples);
+
+    template<typename Codec>
+    void processFixed(float* output, const float* input, unsigned int numChannels);
+
+    template<typename Codec>
+    void processModulated(float* const* audioOutput, const float* const* audioInput, const float* const* modInput,
+                          unsigned int numChannels, unsigned int numSamples);
+
+    template<typename Codec>
+    void processModulated(float* audioOutput, const float* audioInput, const float* modInput, unsigned int numChannels);
+
+    template<typename Codec>
+    void processInterpolated(float* const* audioOutput, const float* const* audioInput, const float* const* modInput,
+                             unsigned int numChannels, unsigned int numSamples);
+
+    template<typename Codec>
+    void readInterpolated(float* const* audioOutput, const float* const* modInput, unsigned int numChannels, unsigned int numSamples);
+
+    template<typename Codec>
+    void readTapsInterpolated(float* audioOutput, const float* tapDelays, unsigned int numTaps, unsigned int channel, unsigned int numSamples);
+
+    template<typename Codec>
+    void writeBlock(const float* const* audioInput, unsigned int numChannels, unsigned int numSamples);
+
+    template<typename Codec>
+    void processFrame(float* const* audioOutput, const float* const* audioInput, const float* const* modInput,
+                            unsigned int numChannels);
 };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,306 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace DSP
+{
+
+// A fixed set of ADSR envelopes advanced together
+// Levels and segment coefficients are stored as arrays, one slot per envelope,
+// and every step advances all of them in a single branchless loop.
+// Each step is level * multiplier + increment, so the linear digital segments and the
+// exponential analog segments, as in EnvelopeGenerator, share the same loop.
+// Off and sustaining envelopes step with a multiplier of 0, the increment holds their level.
+// Segment ends are counted down for all envelopes at once, only the envelopes
+// reaching one leave the loop to set up their next segment.
+// Setting changes keep the progress of the running segments, as in EnvelopeGenerator.
+// For control rate use, prepare with the control rate instead of the sample rate.
+template<typename F, unsigned int N>
+class EnvelopeBank
+{
+public:
+    EnvelopeBank()
+    {
+        for (unsigned int i = 0; i < N; ++i)
+        {
+            timeMs[i][Attack] = static_cast<F>(10);
+            timeMs[i][Decay] = static_cast<F>(5);
+            timeMs[i][Release] = static_cast<F>(50);
+            sustainLevel[i] = static_cast<F>(1);
+            updateTimes(i);
+            enterSegment(i, Off);
+        }
+    }
+
+    ~EnvelopeBank() { }
+
+    // No copy semantics
+    EnvelopeBank(const EnvelopeBank&) = delete;
+    const EnvelopeBank& operator=(const EnvelopeBank&) = delete;
+
+    // No move semantics
+    EnvelopeBank(EnvelopeBank&&) = delete;
+    const EnvelopeBank& operator=(EnvelopeBank&&) = delete;
+
+    // Update sample rate of the segment times and turn all envelopes off
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        for (unsigned int i = 0; i < N; ++i)
+        {
+            updateTimes(i);
+            level[i] = static_cast<F>(0);
+            enterSegment(i, Off);
+        }
+    }
+
+    // Trigger the beginning of an envelope - note on
+    void start(unsigned int index) { enterSegment(index, Attack); }
+
+    // Trigger the ending of an envelope - note off
+    void end(unsigned int index) { enterSegment(index, Release); }
+
+    bool isOff(unsigned int index) const noexcept { return state[index] == Off; }
+
+    // The setters below restart the affected segment from the current level,
+    // digital segments only run for the rest of their time
+
+    void setAnalogStyle(unsigned int index, bool isAnalogStyle)
+    {
+        analogStyle[index] = isAnalogStyle;
+
+        // The current segment starts over in the new style
+        if (state[index] != Off)
+            enterSegment(index, state[index]);
+    }
+
+    void setAttackTime(unsigned int index, F attackTimeMs)
+    {
+        timeMs[index][Attack] = std::max(attackTimeMs, minTimeMs);
+        updateTimes(index);
+        restartSegment(index, Attack);
+    }
+
+    void setDecayTime(unsigned int index, F decayTimeMs)
+    {
+        timeMs[index][Decay] = std::max(decayTimeMs, minTimeMs);
+        updateTimes(index);
+        restartSegment(index, Decay);
+    }
+
+    void setSustainLevel(unsigned int index, F sustainLevelLinear)
+    {
+        sustainLevel[index] = std::clamp(sustainLevelLinear, static_cast<F>(0), static_cast<F>(1));
+        restartSegment(index, Decay);
+        restartSegment(index, Sustain);
+    }
+
+    void setReleaseTime(unsigned int index, F releaseTimeMs)
+    {
+        timeMs[index][Release] = std::max(releaseTimeMs, minTimeMs);
+        updateTimes(index);
+        restartSegment(index, Release);
+    }
+
+    // Advance all envelopes by one step
+    // Returns the N current levels, contiguous
+    const F* getNext()
+    {
+        process(nextLevel, 1);
+        return nextLevel;
+    }
+
+    // Advance all envelopes by a block of steps
+    // Output is filled with numSteps vectors of N levels each, contiguous
+    void process(F* output, unsigned int numSteps)
+    {
+        unsigned int n { 0 };
+        while (n < numSteps)
+        {
+            // All envelopes step together up to the next segment end
+            const unsigned int steps { std::min(stepsToNextEnd, numSteps - n) };
+            step(output + n * N, steps);
+            n += steps;
+
+            // Masked countdown, idle envelopes keep their count
+            for (unsigned int i = 0; i < N; ++i)
+            {
+                remainingSteps[i] -= steps * static_cast<unsigned int>(remainingSteps[i] != Idle);
+                elapsedSteps[i] += steps;
+            }
+            stepsToNextEnd -= steps;
+
+            if (stepsToNextEnd == 0)
+                endSegments(output + (n - 1) * N);
+        }
+    }
+
+    // Current levels without advancing, contiguous
+    const F* getCurrentValues() const noexcept { return level; }
+
+    static constexpr unsigned int NumEnvelopes { N };
+
+    // Minimum segment time in ms
+    static constexpr F minTimeMs { static_cast<F>(0.1) };
+
+    // Analog segments end within this distance of their end value
+    static constexpr F delta { static_cast<F>(1e-3) };
+
+    // Attack target of the analog style, overshooting 1 so the attack ends in finite time
+    static constexpr F analogAttackTarget { static_cast<F>(1.1) };
+
+private:
+    enum Segment : unsigned int
+    {
+        Off = 0,
+        Attack,
+        Decay,
+        Sustain,
+        Release
+    };
+
+    // Step count of the envelopes without a segment end
+    static constexpr unsigned int Idle { std::numeric_limits<unsigned int>::max() };
+
+    double sampleRate { 48000.0 };
+
+    // Per envelope stepping state, one slot each
+    F level[N] {};
+    F multiplier[N] {};
+    F increment[N] {};
+    F limit[N] {};
+    F endValue[N] {};
+    unsigned int remainingSteps[N] {};
+    unsigned int elapsedSteps[N] {}; // steps since the segment was entered
+    Segment state[N] {};
+
+    // Per envelope settings, times indexed by segment
+    F timeMs[N][Release + 1] {};
+    unsigned int timeSamples[N][Release + 1] {};
+    F leakyIntCoeff[N][Release + 1] {};
+    F sustainLevel[N] {};
+    bool analogStyle[N] {};
+
+    // Steps until the first segment end of any envelope
+    unsigned int stepsToNextEnd { Idle };
+
+    F nextLevel[N] {};
+
+    void updateTimes(unsigned int i)
+    {
+        // Only the attack, decay and release slots are used
+        for (unsigned int s = Attack; s <= Release; ++s)
+        {
+            timeSamples[i][s] = static_cast<unsigned int>(std::rint(static_cast<double>(timeMs[i][s]) * sampleRate * 0.001));
+            leakyIntCoeff[i][s] = static_cast<F>(std::exp(-1.0 / static_cast<double>(timeSamples[i][s])));
+        }
+    }
+
+    // Restart a segment if the envelope is in it, keeping its progress
+    void restartSegment(unsigned int i, Segment s)
+    {
+        if (state[i] == s && s != Off)
+            startRun(i, s);
+    }
+
+    void step(F* output, unsigned int numSteps)
+    {
+        // Envelope state in locals, so stores to the output cannot alias it
+        F l[N], m[N], inc[N], lim[N];
+        std::copy(level, level + N, l);
+        std::copy(multiplier, multiplier + N, m);
+        std::copy(increment, increment + N, inc);
+        std::copy(limit, limit + N, lim);
+
+        for (unsigned int n = 0; n < numSteps; ++n)
+        {
+            for (unsigned int i = 0; i < N; ++i)
+            {
+                l[i] = std::min(l[i] * m[i] + inc[i], lim[i]);
+                output[n * N + i] = l[i];
+            }
+        }
+
+        std::copy(l, l + N, level);
+    }
+
+    // Land the envelopes at the end of their segment on their end value and move them on
+    void endSegments(F* lastOutput)
+    {
+        for (unsigned int i = 0; i < N; ++i)
+        {
+            if (remainingSteps[i] != 0)
+                continue;
+
+            level[i] = lastOutput[i] = endValue[i];
+            enterSegment(i, state[i] == Attack ? Decay : (state[i] == Decay ? Sustain : Off));
+        }
+    }
+
+    // Enter a segment from the current level
+    void enterSegment(unsigned int i, Segment s)
+    {
+        elapsedSteps[i] = 0;
+        startRun(i, s);
+    }
+
+    // Run the rest of a segment from the current level
+    void startRun(unsigned int i, Segment s)
+    {
+        state[i] = s;
+
+        if (s == Off || s == Sustain)
+        {
+            // A new sustain level shows from the next step, as in EnvelopeGenerator
+            if (s == Off)
+                level[i] = static_cast<F>(0);
+            multiplier[i] = static_cast<F>(0);
+            increment[i] = s == Off ? static_cast<F>(0) : sustainLevel[i];
+            limit[i] = static_cast<F>(1);
+            remainingSteps[i] = Idle;
+        }
+        else
+        {
+            const F target { s == Attack ? (analogStyle[i] ? analogAttackTarget : static_cast<F>(1)) : (s == Decay ? sustainLevel[i] : static_cast<F>(0)) };
+            endValue[i] = s == Attack ? static_cast<F>(1) : target;
+            limit[i] = std::max(level[i], static_cast<F>(1));
+
+            unsigned int runSteps { 0 };
+            if (analogStyle[i])
+            {
+                // The distance to the target shrinks by the coefficient every step,
+                // the segment lasts until the level is within delta of its end value
+                const F coeff { leakyIntCoeff[i][s] };
+                const F distance { std::abs(level[i] - target) };
+                const F tolerance { std::abs(endValue[i] - target) + delta };
+                if (distance <= tolerance)
+                    runSteps = 0;
+                else if (coeff <= static_cast<F>(0))
+                    runSteps = 1;
+                else
+                    runSteps = static_cast<unsigned int>(std::ceil(std::log(tolerance / distance) / std::log(coeff)));
+
+                multiplier[i] = coeff;
+                increment[i] = (static_cast<F>(1) - coeff) * target;
+            }
+            else
+            {
+                // Straight line to the target over the rest of the segment time,
+                // a setting change keeps at least one step of it
+                const unsigned int segmentSteps { timeSamples[i][s] };
+                runSteps = segmentSteps > 0 ? segmentSteps - std::min(segmentSteps - 1, elapsedSteps[i]) : 0;
+                multiplier[i] = static_cast<F>(1);
+                increment[i] = runSteps > 0 ? (target - level[i]) / static_cast<F>(runSteps) : static_cast<F>(0);
+            }
+
+            // The step after the run lands on the end value
+            remainingSteps[i] = runSteps + 1;
+        }
+
+        stepsToNextEnd = *std::min_element(remainingSteps, remainingSteps + N);
+    }
+};
+
+}
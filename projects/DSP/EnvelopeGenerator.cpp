@@ -28,35 +28,100 @@ void EnvelopeGenerator::prepare(double newSampleRate)
     decayLeakyIntCoeff = std::exp(-1.f / static_cast<float>(decayTimeSamples));
     releaseLeakyIntCoeff = std::exp(-1.f / static_cast<float>(releaseTimeSamples));
 
-    // reset counters and state
+    // reset state
     state = OFF;
-    attackSamplesCounter = 0;
-    decaySamplesCounter = 0;
-    releaseSamplesCounter = 0;
+    segmentCounter = 0;
+    runLength = 0;
+    runPosition = 0;
+    numScheduled = 0;
 }
 
 void EnvelopeGenerator::process(float* output, unsigned int numSamples)
 {
-    if (isAnalogStyle)
-        doAnalog(output, numSamples);
-    else
-        doDigital(output, numSamples);
+    // The block is split at the transitions falling inside it
+    unsigned int n { 0 };
+    while (numScheduled > 0 && scheduled[0].offset < numSamples)
+    {
+        const ScheduledSegment next { scheduled[0] };
+        std::copy(scheduled + 1, scheduled + numScheduled, scheduled);
+        --numScheduled;
+
+        renderSegments(output + n, next.offset - n);
+        n = next.offset;
+        startSegment(next.state);
+    }
+
+    renderSegments(output + n, numSamples - n);
+
+    // The remaining ones move closer
+    for (unsigned int i = 0; i < numScheduled; ++i)
+        scheduled[i].offset -= numSamples;
 }
 
-void EnvelopeGenerator::start()
+void EnvelopeGenerator::start(unsigned int offset)
 {
-    state = ATTACK;
-    attackSamplesCounter = 0;
-    decaySamplesCounter = 0;
-    releaseSamplesCounter = 0;
+    schedule(ATTACK, offset);
 }
 
-void EnvelopeGenerator::end()
+void EnvelopeGenerator::end(unsigned int offset)
 {
-    state = RELEASE;
-    attackSamplesCounter = 0;
-    decaySamplesCounter = 0;
-    releaseSamplesCounter = 0;
+    schedule(RELEASE, offset);
+}
+
+void EnvelopeGenerator::schedule(EnvelopeState newState, unsigned int offset)
+{
+    if (offset == 0 && numScheduled == 0)
+    {
+        startSegment(newState);
+        return;
+    }
+
+    // Kept in time order, a transition never goes before one scheduled earlier
+    if (numScheduled > 0)
+        offset = std::max(offset, scheduled[numScheduled - 1].offset);
+
+    // When full, the latest one is superseded
+    if (numScheduled == MaxScheduled)
+        --numScheduled;
+
+    scheduled[numScheduled++] = { newState, offset };
+}
+
+void EnvelopeGenerator::renderSegments(float* output, unsigned int numSamples)
+{
+    unsigned int n { 0 };
+    while (n < numSamples)
+    {
+        switch (state)
+        {
+        case OFF:
+            currentEnvelope = 0.f;
+            std::fill(output + n, output + numSamples, currentEnvelope);
+            return;
+
+        case SUSTAIN:
+            currentEnvelope = sustainLevel;
+            std::fill(output + n, output + numSamples, currentEnvelope);
+            return;
+
+        default:
+            {
+                // As much of the run as fits in the block
+                const unsigned int runSamples { std::min(runLength - runPosition, numSamples - n) };
+                renderRun(output + n, runSamples);
+                n += runSamples;
+
+                // Run over, its end value sample starts the next segment
+                if (n < numSamples)
+                {
+                    currentEnvelope = runEndValue;
+                    output[n++] = currentEnvelope;
+                    startSegment(state == ATTACK ? DECAY : (state == DECAY ? SUSTAIN : OFF));
+                }
+            }
+            break;
+        }
+    }
 }
 
 void EnvelopeGenerator::setAnalogStyle(bool newAnalogStyle)
@@ -67,13 +132,13 @@ void EnvelopeGenerator::setAnalogStyle(bool newAnalogStyle)
     decayTimeSamples = std::rint(decayTimeMs * static_cast<float>(sampleRate * 0.001));
     releaseTimeSamples = std::rint(releaseTimeMs * static_cast<float>(sampleRate * 0.001));
 
-    attackSamplesCounter = 0;
-    decaySamplesCounter = 0;
-    releaseSamplesCounter = 0;
-
     attackLeakyIntCoeff = std::exp(-1.f / static_cast<float>(attackTimeSamples));
     decayLeakyIntCoeff = std::exp(-1.f / static_cast<float>(decayTimeSamples));
     releaseLeakyIntCoeff = std::exp(-1.f / static_cast<float>(releaseTimeSamples));
+
+    // The current segment starts over in the new style
+    segmentCounter = 0;
+    restartSegment();
 }
 
 void EnvelopeGenerator::setAttackTime(float newAttackTimeMs)
@@ -83,7 +148,7 @@ void EnvelopeGenerator::setAttackTime(float newAttackTimeMs)
     attackLeakyIntCoeff = std::exp(-1.f / static_cast<float>(attackTimeSamples));
 
     if (state == ATTACK)
-        attackSamplesCounter = std::min(attackTimeSamples - 1, attackSamplesCounter);
+        restartSegment();
 }
 
 void EnvelopeGenerator::setDecayTime(float newDecayTimeMs)
@@ -93,12 +158,15 @@ void EnvelopeGenerator::setDecayTime(float newDecayTimeMs)
     decayLeakyIntCoeff = std::exp(-1.f / static_cast<float>(decayTimeSamples));
 
     if (state == DECAY)
-        decaySamplesCounter = std::min(decayTimeSamples - 1, decaySamplesCounter);
+        restartSegment();
 }
 
 void EnvelopeGenerator::setSustainLevel(float newSustainLevelLinear)
 {
     sustainLevel = std::clamp(newSustainLevelLinear, 0.f, 1.f);
+
+    if (state == DECAY)
+        restartSegment();
 }
 
 void EnvelopeGenerator::setReleaseTime(float newReleaseTimeMs)
@@ -108,134 +176,127 @@ void EnvelopeGenerator::setReleaseTime(float newReleaseTimeMs)
     releaseLeakyIntCoeff = std::exp(-1.f / static_cast<float>(releaseTimeSamples));
 
     if (state == RELEASE)
-        releaseSamplesCounter = std::min(releaseTimeSamples - 1, releaseSamplesCounter);
+        restartSegment();
 }
 
-void EnvelopeGenerator::doDigital(float* output, unsigned int numSamples)
+void EnvelopeGenerator::startSegment(EnvelopeState newState)
 {
-    for (unsigned int n = 0; n < numSamples; ++n)
-    {
-        switch (state)
-        {
-        case OFF:
-            {
-                currentEnvelope = 0.f;
-            }
-            break;
-
-        case ATTACK:
-            if (attackSamplesCounter < attackTimeSamples)
-            {
-                currentEnvelope += (1.f - currentEnvelope) / std::fmax(static_cast<float>(attackTimeSamples - attackSamplesCounter), 1.f);
-                currentEnvelope = std::fmin(currentEnvelope, 1.f);
-                ++attackSamplesCounter;
-            }
-            else
-            {
-                attackSamplesCounter = 0;
-                state = DECAY;
-            }
-            break;
-
-        case DECAY:
-            if (decaySamplesCounter < decayTimeSamples)
-            {
-                currentEnvelope += (sustainLevel - currentEnvelope) / std::fmax(static_cast<float>(decayTimeSamples - decaySamplesCounter), 1.f);
-                ++decaySamplesCounter;
-            }
-            else
-            {
-                decaySamplesCounter = 0;
-                state = SUSTAIN;
-            }
-            break;
+    state = newState;
+    segmentCounter = 0;
+    restartSegment();
+}
 
-        case SUSTAIN:
-            {
-                currentEnvelope = sustainLevel;
-            }
-            break;
+void EnvelopeGenerator::restartSegment()
+{
+    unsigned int segmentSamples { 0 };
+    float coeff { 0.f };
 
-        case RELEASE:
-            if (releaseSamplesCounter < releaseTimeSamples)
-            {
-                currentEnvelope += (0.f - currentEnvelope) / std::fmax(static_cast<float>(releaseTimeSamples - releaseSamplesCounter), 1.f);
-                ++releaseSamplesCounter;
-            }
-            else
-            {
-                releaseSamplesCounter = 0;
-                state = OFF;
-            }
-            break;
+    switch (state)
+    {
+    case ATTACK:
+        runTarget = isAnalogStyle ? analogAttackTarget : 1.f;
+        runEndValue = 1.f;
+        segmentSamples = attackTimeSamples;
+        coeff = attackLeakyIntCoeff;
+        break;
+
+    case DECAY:
+        runTarget = sustainLevel;
+        runEndValue = sustainLevel;
+        segmentSamples = decayTimeSamples;
+        coeff = decayLeakyIntCoeff;
+        break;
+
+    case RELEASE:
+        runTarget = 0.f;
+        runEndValue = 0.f;
+        segmentSamples = releaseTimeSamples;
+        coeff = releaseLeakyIntCoeff;
+        break;
+
+    default:
+        runLength = 0;
+        runPosition = 0;
+        return;
+    }
 
-        default: break;
-        }
+    runLimit = std::fmax(currentEnvelope, 1.f);
+    runPosition = 0;
 
-        output[n] = currentEnvelope;
+    if (isAnalogStyle)
+    {
+        // The distance to the target shrinks by coeff every sample,
+        // the run lasts until the envelope is within delta of its end value
+        runOffset = currentEnvelope - runTarget;
+        runMultiplier = coeff;
+
+        const float distance { std::fabs(runOffset) };
+        const float tolerance { std::fabs(runEndValue - runTarget) + delta };
+        if (distance <= tolerance)
+            runLength = 0;
+        else if (coeff <= 0.f)
+            runLength = 1;
+        else
+            runLength = static_cast<unsigned int>(std::ceil(std::log(tolerance / distance) / std::log(coeff)));
+    }
+    else
+    {
+        // Straight line to the target over the rest of the segment time,
+        // a setting change keeps at least one sample of it
+        runLength = segmentSamples > 0 ? segmentSamples - std::min(segmentSamples - 1, segmentCounter) : 0;
+        runStep = runLength > 0 ? (currentEnvelope - runTarget) / static_cast<float>(runLength) : 0.f;
     }
 }
 
-void EnvelopeGenerator::doAnalog(float* output, unsigned int numSamples)
+void EnvelopeGenerator::renderRun(float* output, unsigned int numSamples)
 {
-    for (unsigned int n = 0; n < numSamples; ++n)
-    {
-        switch (state)
-        {
-        case OFF:
-            {
-                currentEnvelope = 0.f;
-            }
-            break;
+    if (numSamples == 0)
+        return;
 
-        case ATTACK:
-            if (std::fabs(currentEnvelope - 1.f) > delta)
-            {
-                currentEnvelope = (currentEnvelope - 1.1f) * attackLeakyIntCoeff + 1.1f;
-                currentEnvelope = std::fmin(currentEnvelope, 1.f);
-            }
-            else
-            {
-                currentEnvelope = 1.f;
-                state = DECAY;
-            }
-            break;
-
-        case DECAY:
-            if (std::fabs(currentEnvelope - sustainLevel) > delta)
-            {
-                currentEnvelope = (currentEnvelope - sustainLevel) * decayLeakyIntCoeff + sustainLevel;
-            }
-            else
-            {
-                currentEnvelope = sustainLevel;
-                state = SUSTAIN;
-            }
-            break;
+    const float target { runTarget };
+    const float limit { runLimit };
 
-        case SUSTAIN:
-            {
-                currentEnvelope = sustainLevel;
-            }
-            break;
+    if (isAnalogStyle)
+    {
+        // Powers of the multiplier for a group of samples, so the group is filled in parallel
+        constexpr unsigned int Group { 8 };
+        float powers[Group];
+        float power { runMultiplier };
+        for (unsigned int j = 0; j < Group; ++j)
+        {
+            powers[j] = power;
+            power *= runMultiplier;
+        }
 
-        case RELEASE:
-            if (std::fabs(currentEnvelope - 0.f) > delta)
-            {
-                currentEnvelope = (currentEnvelope - 0.f) * releaseLeakyIntCoeff + 0.f;
-            }
-            else
-            {
-                currentEnvelope = 0.f;
-                state = OFF;
-            }
-            break;
+        float offset { runOffset };
+        unsigned int n { 0 };
+        for (; n + Group <= numSamples; n += Group)
+        {
+            for (unsigned int j = 0; j < Group; ++j)
+                output[n + j] = std::min(target + offset * powers[j], limit);
+            offset *= powers[Group - 1];
+        }
 
-        default: break;
+        for (; n < numSamples; ++n)
+        {
+            offset *= runMultiplier;
+            output[n] = std::min(target + offset, limit);
         }
 
-        output[n] = currentEnvelope;
+        runOffset = offset;
+    }
+    else
+    {
+        // Distance to the target counts down to 0 on the last sample of the run
+        const float step { runStep };
+        const unsigned int stepsLeft { runLength - 1 - runPosition };
+        for (unsigned int n = 0; n < numSamples; ++n)
+            output[n] = std::min(target + step * static_cast<float>(stepsLeft - n), limit);
     }
+
+    runPosition += numSamples;
+    segmentCounter += numSamples;
+    currentEnvelope = output[numSamples - 1];
 }
 
 }
@@ -18,12 +18,15 @@ public:
     void process(float* output, unsigned int numSamples);
 
     // trigger the beginning of the envelope - note on
-    void start();
+    // offset is the sample of the next process call the attack starts at,
+    // offsets past its end carry over to the following calls
+    void start(unsigned int offset = 0);
 
-    // trigger the ending of the envelope - note off
-    void end();
+    // trigger the ending of the envelope - note off, offset as for start
+    void end(unsigned int offset = 0);
 
-    bool isOff() const { return state == OFF; }
+    // Off and nothing scheduled
+    bool isOff() const { return state == OFF && numScheduled == 0; }
 
     void setAnalogStyle(bool isAnalogStyle);
     void setAttackTime(float attackTimeMs);
@@ -44,10 +47,6 @@ private:
     unsigned int decayTimeSamples { 0 };
     unsigned int releaseTimeSamples { 0 };
 
-    unsigned int attackSamplesCounter { 0 };
-    unsigned int decaySamplesCounter { 0 };
-    unsigned int releaseSamplesCounter { 0 };
-
     float currentEnvelope { 0.f };
 
     float attackLeakyIntCoeff { 0.f };
@@ -69,8 +68,49 @@ private:
 
     static constexpr float delta { 1e-3 };
 
-    void doDigital(float* output, unsigned int numSamples);
-    void doAnalog(float* output, unsigned int numSamples);
+    // Attack target of the analog style, overshooting 1 so the attack ends in finite time
+    static constexpr float analogAttackTarget { 1.1f };
+
+    // The current segment is rendered as a closed form run from the value it (re)started at,
+    // linear for the digital style and exponential for the analog style.
+    // A run is followed by one sample at its end value, where the next segment starts.
+    float runTarget { 0.f };
+    float runStep { 0.f };       // linear runs, change per sample
+    float runOffset { 0.f };     // exponential runs, distance from the target
+    float runMultiplier { 1.f }; // exponential runs, per sample factor of the distance
+    float runLimit { 1.f };      // runs never go above it
+    float runEndValue { 0.f };
+    unsigned int runLength { 0 };
+    unsigned int runPosition { 0 };
+
+    // Samples rendered since the segment started, across run restarts
+    unsigned int segmentCounter { 0 };
+
+    // Transitions waiting for their offset, in time order
+    struct ScheduledSegment
+    {
+        EnvelopeState state;
+        unsigned int offset;
+    };
+
+    static constexpr unsigned int MaxScheduled { 4 };
+    ScheduledSegment scheduled[MaxScheduled] {};
+    unsigned int numScheduled { 0 };
+
+    // Enter a segment now, or at an offset into the next process calls
+    void schedule(EnvelopeState newState, unsigned int offset);
+
+    // Render the segments from the current state on, without scheduled transitions
+    void renderSegments(float* output, unsigned int numSamples);
+
+    // Enter a segment from the current envelope value
+    void startSegment(EnvelopeState newState);
+
+    // Restart the run of the current segment after a setting change, keeping its progress
+    void restartSegment();
+
+    // Render a part of the current run, numSamples must not go past its end value sample
+    void renderRun(float* output, unsigned int numSamples);
 };
 
 }
@@ -0,0 +1,264 @@
+#include "FDNReverb.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace DSP
+{
+
+namespace
+{
+
+// Line lengths at full size in ms, spread and mutually prime in samples at usual rates
+// 8 line networks use every other length
+constexpr float LineLengthsMs[FDNReverb::MaxLines]
+{
+    31.3f, 37.1f, 41.9f, 47.3f, 53.1f, 59.9f, 66.7f, 71.3f,
+    79.1f, 83.9f, 89.3f, 97.1f, 101.9f, 107.3f, 113.1f, 119.9f
+};
+
+// Alternating sign pattern used for injection and taps, decorrelates the channels
+constexpr float lineSign(unsigned int line)
+{
+    return ((line >> 1u) & 1u) ? -1.f : 1.f;
+}
+
+}
+
+FDNReverb::FDNReverb(unsigned int numLinesToUse) :
+    numLines { numLinesToUse > 8u ? MaxLines : 8u }
+{
+    for (unsigned int i = 0; i < numLines; ++i)
+    {
+        delayLines.emplace_back(std::make_unique<DelayLine>(getLineBufferSize(i, numLines, sampleRate), 1u));
+        dampingFilters.emplace_back(std::make_unique<ParametricEqualizer>(1u, 1u));
+    }
+}
+
+FDNReverb::FDNReverb(MemoryArena& newArena, unsigned int numLinesToUse) :
+    numLines { numLinesToUse > 8u ? MaxLines : 8u }
+{
+    for (unsigned int i = 0; i < numLines; ++i)
+    {
+        delayLines.emplace_back(std::make_unique<DelayLine>(newArena, getLineBufferSize(i, numLines, sampleRate), 1u));
+        dampingFilters.emplace_back(std::make_unique<ParametricEqualizer>(1u, 1u));
+    }
+}
+
+FDNReverb::~FDNReverb()
+{
+}
+
+void FDNReverb::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+
+    for (unsigned int i = 0; i < numLines; ++i)
+    {
+        delayLines[i]->prepare(getLineBufferSize(i, numLines, sampleRate), 1u);
+        delayLines[i]->setSmoothingTime(SizeSmoothingSec, sampleRate);
+
+        dampingFilters[i]->setBandType(0, ParametricEqualizer::HighShelf);
+        dampingFilters[i]->setBandResonance(0, static_cast<float>(M_SQRT1_2));
+        dampingFilters[i]->setBandFrequency(0, dampingFrequency);
+        dampingFilters[i]->prepare(sampleRate, 1u);
+    }
+
+    // Sub-blocks must not be longer than the shortest line, so the feedback stays causal
+    const auto minLineSamples { static_cast<unsigned int>(getLineDelaySamples(0, MinSize)) };
+    subBlockSize = std::clamp(minLineSamples, 1u, SubBlockSize);
+
+    updateLengths(true);
+    updateGains();
+    clear();
+}
+
+void FDNReverb::clear()
+{
+    for (auto& line : delayLines)
+        line->clear();
+
+    for (auto& filter : dampingFilters)
+        filter->clear();
+}
+
+void FDNReverb::process(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples)
+{
+    if (numChannels == 0)
+        return;
+
+    const float ioGain { std::sqrt(static_cast<float>(numChannels) / static_cast<float>(numLines)) };
+
+    for (unsigned int offset = 0; offset < numSamples; offset += subBlockSize)
+    {
+        const unsigned int blockSize { std::min(subBlockSize, numSamples - offset) };
+
+        // Read all lines
+        for (unsigned int i = 0; i < numLines; ++i)
+        {
+            float* line[1] { lineBuffer[i] };
+            delayLines[i]->read(line, nullptr, 1u, blockSize);
+        }
+
+        // Output taps
+        for (unsigned int ch = 0; ch < numChannels; ++ch)
+        {
+            float* out { output[ch] + offset };
+            std::fill(out, out + blockSize, 0.f);
+
+            for (unsigned int i = ch % numLines; i < numLines; i += numChannels)
+            {
+                const float gain { lineSign(i) * ioGain };
+                for (unsigned int n = 0; n < blockSize; ++n)
+                    out[n] += gain * lineBuffer[i][n];
+            }
+        }
+
+        // Damping and decay gain
+        for (unsigned int i = 0; i < numLines; ++i)
+        {
+            float* line[1] { lineBuffer[i] };
+            dampingFilters[i]->process(line, line, 1u, blockSize);
+
+            const float gain { lineGains[i] };
+            for (unsigned int n = 0; n < blockSize; ++n)
+                lineBuffer[i][n] *= gain;
+        }
+
+        // Mix lines thru the feedback matrix
+        applyMatrix(blockSize);
+
+        // Inject input and write back
+        for (unsigned int i = 0; i < numLines; ++i)
+        {
+            const float* in { input[i % numChannels] + offset };
+            const float gain { lineSign(i) * ioGain };
+            for (unsigned int n = 0; n < blockSize; ++n)
+                lineBuffer[i][n] += gain * in[n];
+
+            const float* line[1] { lineBuffer[i] };
+            delayLines[i]->write(line, 1u, blockSize);
+        }
+    }
+}
+
+void FDNReverb::setDecayTime(float decayTimeSec)
+{
+    decayTime = std::clamp(decayTimeSec, 0.1f, 30.f);
+    updateGains();
+}
+
+void FDNReverb::setSize(float sizeNorm)
+{
+    size = std::clamp(sizeNorm, 0.f, 1.f);
+    updateLengths(false);
+    updateGains();
+}
+
+void FDNReverb::setDampingFrequency(float dampingFreqHz)
+{
+    dampingFrequency = std::clamp(dampingFreqHz, 200.f, 20000.f);
+    for (auto& filter : dampingFilters)
+        filter->setBandFrequency(0, dampingFrequency);
+}
+
+void FDNReverb::setDampingRatio(float ratio)
+{
+    dampingRatio = std::clamp(ratio, 0.05f, 1.f);
+    updateGains();
+}
+
+void FDNReverb::setMatrixType(MatrixType type)
+{
+    matrixType = type;
+    updateGains();
+}
+
+size_t FDNReverb::getRequiredBytes(double maxSampleRate, unsigned int numLinesToUse)
+{
+    const unsigned int lines { numLinesToUse > 8u ? MaxLines : 8u };
+
+    size_t bytes { 0 };
+    for (unsigned int i = 0; i < lines; ++i)
+        bytes += DelayLine::getRequiredBytes(getLineBufferSize(i, lines, maxSampleRate), 1u);
+    return bytes;
+}
+
+float FDNReverb::getLineDelaySamples(unsigned int line, float sizeNorm) const
+{
+    // 8 line networks take every other length
+    const unsigned int index { line * (MaxLines / numLines) };
+    const float scale { MinSize + (1.f - MinSize) * sizeNorm };
+    return LineLengthsMs[index] * scale * static_cast<float>(0.001 * sampleRate);
+}
+
+unsigned int FDNReverb::getLineBufferSize(unsigned int line, unsigned int lines, double sampleRate)
+{
+    // Full size length, with room for the interpolation and smoothing overshoot
+    return static_cast<unsigned int>(std::ceil(LineLengthsMs[line * (MaxLines / lines)] * static_cast<float>(0.001 * sampleRate))) + 4u;
+}
+
+void FDNReverb::updateLengths(bool skipSmoothing)
+{
+    for (unsigned int i = 0; i < numLines; ++i)
+        delayLines[i]->setDelay(getLineDelaySamples(i, size), skipSmoothing);
+}
+
+void FDNReverb::updateGains()
+{
+    // The unnormalised Hadamard transform scales by sqrt(N)
+    const float matrixGain { matrixType == Hadamard ? 1.f / std::sqrt(static_cast<float>(numLines)) : 1.f };
+
+    const float hfDecayTime { decayTime * dampingRatio };
+    for (unsigned int i = 0; i < numLines; ++i)
+    {
+        // Attenuation per pass for the line length to reach -60dB at the decay time
+        const float lineSec { getLineDelaySamples(i, size) / static_cast<float>(sampleRate) };
+        const float lineDb { -60.f * lineSec / decayTime };
+        const float hfDb { -60.f * lineSec / hfDecayTime };
+
+        lineGains[i] = matrixGain * std::pow(10.f, 0.05f * lineDb);
+        dampingFilters[i]->setBandGain(0, hfDb - lineDb);
+    }
+}
+
+void FDNReverb::applyMatrix(unsigned int numSamples)
+{
+    if (matrixType == Hadamard)
+    {
+        // Fast Walsh-Hadamard transform, butterflies between line pairs run over the whole block
+        for (unsigned int h = 1; h < numLines; h <<= 1)
+        {
+            for (unsigned int i = 0; i < numLines; i += (h << 1))
+            {
+                for (unsigned int j = i; j < i + h; ++j)
+                {
+                    float* a { lineBuffer[j] };
+                    float* b { lineBuffer[j + h] };
+                    for (unsigned int n = 0; n < numSamples; ++n)
+                    {
+                        const float sum { a[n] + b[n] };
+                        const float diff { a[n] - b[n] };
+                        a[n] = sum;
+                        b[n] = diff;
+                    }
+                }
+            }
+        }
+    }
+    else
+    {
+        // Householder reflection, I - 2/N * ones
+        std::fill(mixBuffer, mixBuffer + numSamples, 0.f);
+        for (unsigned int i = 0; i < numLines; ++i)
+            for (unsigned int n = 0; n < numSamples; ++n)
+                mixBuffer[n] += lineBuffer[i][n];
+
+        const float scale { 2.f / static_cast<float>(numLines) };
+        for (unsigned int i = 0; i < numLines; ++i)
+            for (unsigned int n = 0; n < numSamples; ++n)
+                lineBuffer[i][n] -= scale * mixBuffer[n];
+    }
+}
+
+}
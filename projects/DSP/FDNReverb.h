@@ -0,0 +1,103 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "DelayLine.h"
+#include "MemoryArena.h"
+#include "ParametricEqualizer.h"
+
+namespace DSP
+{
+
+class FDNReverb
+{
+public:
+    // Unitary feedback matrix mixing the delay lines
+    enum MatrixType : unsigned int
+    {
+        Hadamard = 0, // dense mixing, computed as a fast Walsh-Hadamard transform
+        Householder   // reflection about the mean, cheaper but less diffuse
+    };
+
+    // Main ctor, the number of lines is rounded to 8 or 16
+    FDNReverb(unsigned int numLines = 16);
+
+    // Arena backed ctor, the delay line buffers are sliced from the shared arena
+    FDNReverb(MemoryArena& arena, unsigned int numLines = 16);
+    ~FDNReverb();
+
+    // No copy semantics
+    FDNReverb(const FDNReverb&) = delete;
+    const FDNReverb& operator=(const FDNReverb&) = delete;
+
+    // No move semantics
+    FDNReverb(FDNReverb&&) = delete;
+    const FDNReverb& operator=(FDNReverb&&) = delete;
+
+    // Update sample rate, reallocates and clear internal buffers
+    void prepare(double sampleRate);
+
+    // Clear contents of internal buffers
+    void clear();
+
+    // Arena space needed when preparing up to maxSampleRate
+    static size_t getRequiredBytes(double maxSampleRate, unsigned int numLines = 16);
+
+    // Process audio, output is the reverb signal only
+    // Output buffers must not alias the input ones
+    // Input and output channels are spread alternately over the delay lines
+    void process(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples);
+
+    // Set decay time to -60dB in seconds
+    void setDecayTime(float decayTimeSec);
+
+    // Set room size normalised, scales the delay line lengths
+    void setSize(float sizeNorm);
+
+    // Set the frequency above which the decay gets shorter in Hz
+    void setDampingFrequency(float dampingFreqHz);
+
+    // Set the high frequency decay time as a ratio of the decay time
+    void setDampingRatio(float ratio);
+
+    // Set feedback matrix type
+    void setMatrixType(MatrixType type);
+
+    unsigned int getNumLines() const noexcept { return numLines; }
+
+    static constexpr unsigned int MaxLines { 16 };
+
+private:
+    double sampleRate { 48000.0 };
+    const unsigned int numLines;
+
+    std::vector<std::unique_ptr<DelayLine>> delayLines;
+    std::vector<std::unique_ptr<ParametricEqualizer>> dampingFilters;
+
+    // Per line feedback gain, includes the matrix normalisation
+    float lineGains[MaxLines] {};
+
+    // Scratch buffers for the sub-block processing, one row per line
+    static constexpr unsigned int SubBlockSize { 64 };
+    float lineBuffer[MaxLines][SubBlockSize] {};
+    float mixBuffer[SubBlockSize] {};
+    unsigned int subBlockSize { SubBlockSize };
+
+    float decayTime { 2.f };
+    float size { 0.5f };
+    float dampingFrequency { 4000.f };
+    float dampingRatio { 0.3f };
+    MatrixType matrixType { Hadamard };
+
+    static constexpr float MinSize { 0.25f };
+    static constexpr float SizeSmoothingSec { 0.1f };
+
+    float getLineDelaySamples(unsigned int line, float sizeNorm) const;
+    static unsigned int getLineBufferSize(unsigned int line, unsigned int numLines, double sampleRate);
+    void updateLengths(bool skipSmoothing);
+    void updateGains();
+    void applyMatrix(unsigned int numSamples);
+};
+
+}
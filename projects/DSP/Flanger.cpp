@@ -1,5 +1,6 @@
 #include "Flanger.h"
 
+#include <algorithm>
 #include <cmath>
 
 namespace DSP
@@ -7,7 +8,12 @@ namespace DSP
 
 Flanger::Flanger(float maxTimeMs, unsigned int numChannels) :
     delayLine(static_cast<unsigned int>(std::ceil(std::fmax(maxTimeMs, 1.f) * static_cast<float>(0.001 * sampleRate))), numChannels),
-    offsetRamp(0.05f),
+    modDepthRamp(0.05f)
+{
+}
+
+Flanger::Flanger(MemoryArena& arena, float maxTimeMs, unsigned int numChannels) :
+    delayLine(arena, static_cast<unsigned int>(std::ceil(std::fmax(maxTimeMs, 1.f) * static_cast<float>(0.001 * sampleRate))), numChannels),
     modDepthRamp(0.05f)
 {
 }
@@ -21,14 +27,14 @@ void Flanger::prepare(double newSampleRate, float maxTimeMs, unsigned int numCha
     sampleRate = newSampleRate;
 
     delayLine.prepare(static_cast<unsigned int>(std::round(maxTimeMs * static_cast<float>(0.001 * sampleRate))), MaxChannels);
-    delayLine.setDelaySamples(static_cast<unsigned int>(std::ceil(0.001 * sampleRate))); // Set fixed delay to 1ms
+    delayLine.setSmoothingTime(0.05f, sampleRate);
+    delayLine.setDelay(offsetMs * static_cast<float>(0.001 * sampleRate), true);
 
-    offsetRamp.prepare(sampleRate, true, offsetMs * static_cast<float>(0.001 * sampleRate));
     modDepthRamp.prepare(sampleRate, true, modDepthMs * static_cast<float>(0.001 * sampleRate));
 
-    phaseState[0] = 0.f;
-    phaseState[1] = static_cast<float>(M_PI / 2.0);
-    phaseInc = static_cast<float>(2.0 * M_PI / sampleRate) * modRate;
+    lfo.setFrequency(modRate);
+    lfo.setWaveform(modType == Tri ? LFO::Tri : LFO::Sin);
+    lfo.prepare(sampleRate);
 }
 
 void Flanger::clear()
@@ -36,55 +42,47 @@ void Flanger::clear()
     delayLine.clear();
 }
 
-void Flanger::process(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples)
+size_t Flanger::getRequiredBytes(double maxSampleRate, float maxTimeMs)
 {
-    for (unsigned int n = 0; n < numSamples; ++n)
-    {
-        // Process LFO acording to mod type
-        float lfo[2] { 0.f, 0.f };
-        switch (modType)
-        {
-        case Tri:
-            lfo[0] = std::fabs((phaseState[0] - static_cast<float>(M_PI)) / static_cast<float>(M_PI));
-            lfo[1] = std::fabs((phaseState[1] - static_cast<float>(M_PI)) / static_cast<float>(M_PI));
-            break;
-
-        case Sin:
-            lfo[0] = 0.5f + 0.5f * std::sin(phaseState[0]);
-            lfo[1] = 0.5f + 0.5f * std::sin(phaseState[1]);
-            break;
-        }
-
-        // Increment and wrap phase states
-        phaseState[0] = std::fmod(phaseState[0] + phaseInc, static_cast<float>(2 * M_PI));
-        phaseState[1] = std::fmod(phaseState[1] + phaseInc, static_cast<float>(2 * M_PI));
+    return DelayLine::getRequiredBytes(static_cast<unsigned int>(std::round(maxTimeMs * static_cast<float>(0.001 * maxSampleRate))), MaxChannels);
+}
 
-        // Apply mod depth and offset ramps
-        modDepthRamp.applyGain(lfo, numChannels);
-        offsetRamp.applySum(lfo, numChannels);
+void Flanger::process(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples)
+{
+    numChannels = std::min(numChannels, MaxChannels);
+    float* mod[MaxChannels] { lfoBuffer[0], lfoBuffer[1] };
 
-        // Delay in/out
-        float x[2];
-        float y[2];
+    for (unsigned int offset = 0; offset < numSamples; offset += SubBlockSize)
+    {
+        const unsigned int blockSize { std::min(SubBlockSize, numSamples - offset) };
 
+        // Unipolar LFO, quadrature between L and R
+        lfo.process(mod, numChannels, blockSize);
         for (unsigned int ch = 0; ch < numChannels; ++ch)
-            x[ch] = input[ch][n];
+            for (unsigned int n = 0; n < blockSize; ++n)
+                mod[ch][n] = 0.5f + 0.5f * mod[ch][n];
 
-        // Process delay
-        delayLine.process(y, x, lfo, numChannels);
+        // Apply mod depth ramp, the delay line adds the smoothed offset on top
+        modDepthRamp.applyGain(mod, numChannels, blockSize);
 
-        // Write to output buffers
+        // Process delay
+        const float* x[MaxChannels] { nullptr, nullptr };
+        float* y[MaxChannels] { nullptr, nullptr };
         for (unsigned int ch = 0; ch < numChannels; ++ch)
-            output[ch][n] = y[ch];
+        {
+            x[ch] = input[ch] + offset;
+            y[ch] = output[ch] + offset;
+        }
+
+        delayLine.process(y, x, mod, numChannels, blockSize);
     }
 }
 
 void Flanger::setOffset(float newOffsetMs)
 {
-    // Since the fixed delay is set to 1ms
-    // We can deduct that from the offset ramp
-    offsetMs = std::fmax(newOffsetMs - 1.f, 0.f);
-    offsetRamp.setTarget(offsetMs * static_cast<float>(0.001 * sampleRate));
+    // Keep at least 1ms of delay
+    offsetMs = std::fmax(newOffsetMs, 1.f);
+    delayLine.setDelay(offsetMs * static_cast<float>(0.001 * sampleRate));
 }
 
 void Flanger::setDepth(float newDepthMs)
@@ -96,12 +94,13 @@ void Flanger::setDepth(float newDepthMs)
 void Flanger::setModulationRate(float newModRateHz)
 {
     modRate = std::fmax(newModRateHz, 0.f);
-    phaseInc = static_cast<float>(2.0 * M_PI / sampleRate) * modRate;
+    lfo.setFrequency(modRate);
 }
 
 void Flanger::setModulationType(ModulationType newModType)
 {
     modType = newModType;
+    lfo.setWaveform(modType == Tri ? LFO::Tri : LFO::Sin);
 }
 
 }
\ No newline at end of file
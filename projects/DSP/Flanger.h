@@ -1,6 +1,7 @@
 #pragma once
 
 #include "DelayLine.h"
+#include "LFO.h"
 #include "Ramp.h"
 
 namespace DSP
@@ -16,6 +17,9 @@ public:
     };
 
     Flanger(float maxTimeMs, unsigned int numChannels);
+
+    // Arena backed ctor, the delay buffer is sliced from the shared arena
+    Flanger(MemoryArena& arena, float maxTimeMs, unsigned int numChannels);
     ~Flanger();
 
     // No default ctor
@@ -35,6 +39,9 @@ public:
     // Clear contents of internal buffer
     void clear();
 
+    // Arena space needed when preparing up to maxSampleRate
+    static size_t getRequiredBytes(double maxSampleRate, float maxTimeMs);
+
     // Process audio
     void process(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples);
 
@@ -50,20 +57,21 @@ public:
     // Set delay time modulation waveform type
     void setModulationType(ModulationType newModType);
 
-    static constexpr int MaxChannels { 2 };
+    static constexpr unsigned int MaxChannels { 2 };
 
 private:
     double sampleRate { 48000.0 };
 
     DSP::DelayLine delayLine;
 
-    DSP::Ramp<float> offsetRamp;
     DSP::Ramp<float> modDepthRamp;
+    DSP::LFO lfo;
 
-    float phaseState[2] { 0.f, 0.f };
-    float phaseInc { 0.f };
+    // Scratch buffer for the LFO block
+    static constexpr unsigned int SubBlockSize { 64 };
+    float lfoBuffer[MaxChannels][SubBlockSize] {};
 
-    float offsetMs { 0.f };
+    float offsetMs { 1.f };
     float modDepthMs { 0.f };
     float modRate { 0.f };
 
@@ -0,0 +1,195 @@
+#include "LFO.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace DSP
+{
+
+LFO::LFO()
+{
+}
+
+LFO::~LFO()
+{
+}
+
+void LFO::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    setFrequency(frequency);
+    reset();
+}
+
+void LFO::reset(float startPhase)
+{
+    phase = static_cast<double>(startPhase - std::floor(startPhase));
+    samplesToResync = 0;
+
+    for (unsigned int ch = 0; ch < MaxChannels; ++ch)
+    {
+        heldValue[ch] = 0.f;
+        lastPhase[ch] = 1.f;
+    }
+}
+
+void LFO::process(float* const* output, unsigned int numChannels, unsigned int numSamples)
+{
+    numChannels = std::min(numChannels, MaxChannels);
+
+    unsigned int offset { 0 };
+    while (offset < numSamples)
+    {
+        if (samplesToResync == 0)
+            resync();
+
+        const unsigned int chunk { std::min(numSamples - offset, samplesToResync) };
+        for (unsigned int ch = 0; ch < numChannels; ++ch)
+            generate(output[ch] + offset, ch, chunk);
+
+        advance(chunk);
+        offset += chunk;
+    }
+}
+
+void LFO::process(float* output, unsigned int numChannels)
+{
+    numChannels = std::min(numChannels, MaxChannels);
+
+    if (samplesToResync == 0)
+        resync();
+
+    for (unsigned int ch = 0; ch < numChannels; ++ch)
+        generate(output + ch, ch, 1);
+
+    advance(1);
+}
+
+void LFO::setFrequency(float frequencyHz)
+{
+    frequency = std::fmax(frequencyHz, 0.f);
+    phaseInc = static_cast<double>(frequency) / sampleRate;
+
+    const double rotation { 2.0 * M_PI * phaseInc };
+    rotationSin = static_cast<float>(std::sin(rotation));
+    rotationCos = static_cast<float>(std::cos(rotation));
+}
+
+void LFO::setWaveform(Waveform newWaveform)
+{
+    waveform = std::min(newWaveform, SampleAndHold);
+
+    // The sine recurrence is not advanced by the other waveforms
+    samplesToResync = 0;
+}
+
+void LFO::setChannelPhaseOffset(float offsetCycles)
+{
+    channelPhaseOffset = offsetCycles - std::floor(offsetCycles);
+    samplesToResync = 0;
+}
+
+float LFO::getChannelPhase(unsigned int channel) const
+{
+    const double p { phase + static_cast<double>(channelPhaseOffset) * channel };
+    return static_cast<float>(p - std::floor(p));
+}
+
+void LFO::resync()
+{
+    for (unsigned int ch = 0; ch < MaxChannels; ++ch)
+    {
+        const double p { 2.0 * M_PI * static_cast<double>(getChannelPhase(ch)) };
+        sinState[ch] = static_cast<float>(std::sin(p));
+        cosState[ch] = static_cast<float>(std::cos(p));
+    }
+
+    samplesToResync = ResyncInterval;
+}
+
+void LFO::advance(unsigned int numSamples)
+{
+    phase += phaseInc * numSamples;
+    phase -= std::floor(phase);
+    samplesToResync -= numSamples;
+}
+
+void LFO::generate(float* output, unsigned int channel, unsigned int numSamples)
+{
+    const float p0 { getChannelPhase(channel) };
+    const float inc { static_cast<float>(phaseInc) };
+
+    switch (waveform)
+    {
+        case Sin:
+        {
+            float s { sinState[channel] };
+            float c { cosState[channel] };
+            for (unsigned int n = 0; n < numSamples; ++n)
+            {
+                output[n] = s;
+                const float sNext { s * rotationCos + c * rotationSin };
+                c = c * rotationCos - s * rotationSin;
+                s = sNext;
+            }
+            sinState[channel] = s;
+            cosState[channel] = c;
+        }
+        break;
+
+        case Tri:
+            for (unsigned int n = 0; n < numSamples; ++n)
+            {
+                float p { p0 + inc * static_cast<float>(n) };
+                p -= std::floor(p);
+                output[n] = 2.f * std::fabs(2.f * p - 1.f) - 1.f;
+            }
+            break;
+
+        case Square:
+            for (unsigned int n = 0; n < numSamples; ++n)
+            {
+                float p { p0 + inc * static_cast<float>(n) };
+                p -= std::floor(p);
+                output[n] = p < 0.5f ? -1.f : 1.f;
+            }
+            break;
+
+        case Saw:
+            for (unsigned int n = 0; n < numSamples; ++n)
+            {
+                float p { p0 + inc * static_cast<float>(n) };
+                p -= std::floor(p);
+                output[n] = 2.f * p - 1.f;
+            }
+            break;
+
+        case SampleAndHold:
+        {
+            float held { heldValue[channel] };
+            float last { lastPhase[channel] };
+            for (unsigned int n = 0; n < numSamples; ++n)
+            {
+                float p { p0 + inc * static_cast<float>(n) };
+                p -= std::floor(p);
+
+                // Phase wrapped, take a new value
+                if (p < last)
+                {
+                    randomState ^= randomState << 13;
+                    randomState ^= randomState >> 17;
+                    randomState ^= randomState << 5;
+                    held = static_cast<float>(randomState) * static_cast<float>(2.0 / 4294967295.0) - 1.f;
+                }
+
+                last = p;
+                output[n] = held;
+            }
+            heldValue[channel] = held;
+            lastPhase[channel] = last;
+        }
+        break;
+    }
+}
+
+}
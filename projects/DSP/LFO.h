@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+
+namespace DSP
+{
+
+class LFO
+{
+public:
+    // Bipolar waveforms, phase 0 being the start of the cycle
+    enum Waveform : unsigned int
+    {
+        Sin = 0,      // sin(2 pi p)
+        Tri,          // starts at 1, reaches -1 at half cycle
+        Square,       // -1 for the first half cycle, 1 for the second
+        Saw,          // rising from -1 to 1
+        SampleAndHold // new random value each cycle
+    };
+
+    LFO();
+    ~LFO();
+
+    // No copy semantics
+    LFO(const LFO&) = delete;
+    const LFO& operator=(const LFO&) = delete;
+
+    // No move semantics
+    LFO(LFO&&) = delete;
+    const LFO& operator=(LFO&&) = delete;
+
+    // Update sample rate and reset phase
+    void prepare(double sampleRate);
+
+    // Reset phase, in cycles, defaults to the start of the cycle
+    void reset(float startPhase = 0.f);
+
+    // Generate a block of LFO output, channels are offset by the channel phase offset
+    void process(float* const* output, unsigned int numChannels, unsigned int numSamples);
+
+    // Single sample flavour
+    void process(float* output, unsigned int numChannels);
+
+    // Set LFO frequency in Hz
+    void setFrequency(float frequencyHz);
+
+    // Set LFO waveform
+    void setWaveform(Waveform newWaveform);
+
+    // Set phase offset between consecutive channels in cycles
+    // Defaults to a quarter cycle, quadrature between L and R
+    void setChannelPhaseOffset(float offsetCycles);
+
+    static constexpr unsigned int MaxChannels { 2 };
+
+    // The sine recurrence is reset from the phase accumulator this often,
+    // so amplitude and phase never drift
+    static constexpr unsigned int ResyncInterval { 64 };
+
+private:
+    double sampleRate { 48000.0 };
+    float frequency { 0.f };
+    Waveform waveform { Sin };
+    float channelPhaseOffset { 0.25f };
+
+    // Phase of the first channel in cycles, from 0 to 1
+    double phase { 0.0 };
+    double phaseInc { 0.0 };
+    unsigned int samplesToResync { 0 };
+
+    // Sine rotation recurrence, state and per sample rotation
+    float sinState[MaxChannels] { 0.f, 0.f };
+    float cosState[MaxChannels] { 1.f, 1.f };
+    float rotationSin { 0.f };
+    float rotationCos { 1.f };
+
+    // Sample and hold state
+    float heldValue[MaxChannels] { 0.f, 0.f };
+    float lastPhase[MaxChannels] { 0.f, 0.f };
+    uint32_t randomState { 0x12345678u };
+
+    float getChannelPhase(unsigned int channel) const;
+    void resync();
+    void advance(unsigned int numSamples);
+    void generate(float* output, unsigned int channel, unsigned int numSamples);
+};
+
+}
@@ -0,0 +1,37 @@
+#include "MemoryArena.h"
+
+#include <cstdint>
+
+namespace DSP
+{
+
+MemoryArena::MemoryArena(size_t capacityBytes) :
+    storage(getAlignedSize(capacityBytes) + Alignment, 0),
+    capacity { getAlignedSize(capacityBytes) }
+{
+    // Align the first slice to the cache line
+    const auto address { reinterpret_cast<std::uintptr_t>(storage.data()) };
+    base = storage.data() + (getAlignedSize(address) - address);
+}
+
+MemoryArena::~MemoryArena()
+{
+}
+
+void MemoryArena::reset()
+{
+    used = 0;
+}
+
+unsigned char* MemoryArena::allocate(size_t numBytes)
+{
+    const size_t alignedBytes { getAlignedSize(numBytes) };
+    if (alignedBytes > capacity - used)
+        return nullptr;
+
+    unsigned char* slice { base + used };
+    used += alignedBytes;
+    return slice;
+}
+
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace DSP
+{
+
+// Linear (bump) allocator for DSP buffers
+// The storage is allocated once at construction, sized for the worst case
+// (max sample rate and channel count), and handed out in aligned slices.
+// It is meant to be shared by all the delay based DSP of a plugin instance,
+// keeping their buffers contiguous and free of heap churn on device changes.
+class MemoryArena
+{
+public:
+    MemoryArena(size_t capacityBytes);
+    ~MemoryArena();
+
+    // No default ctor
+    MemoryArena() = delete;
+
+    // No copy semantics
+    MemoryArena(const MemoryArena&) = delete;
+    const MemoryArena& operator=(const MemoryArena&) = delete;
+
+    // No move semantics
+    MemoryArena(MemoryArena&&) = delete;
+    const MemoryArena& operator=(MemoryArena&&) = delete;
+
+    // Rewind the arena, all the slices handed out before become invalid
+    // Call this before (re)preparing all the DSP sharing the arena
+    void reset();
+
+    // Get a slice of numBytes, returns nullptr if it does not fit
+    unsigned char* allocate(size_t numBytes);
+
+    size_t getCapacity() const noexcept { return capacity; }
+    size_t getUsedBytes() const noexcept { return used; }
+
+    // Round a slice size up to the arena alignment
+    static constexpr size_t getAlignedSize(size_t numBytes) { return (numBytes + Alignment - 1) & ~(Alignment - 1); }
+
+    // Slices are cache line aligned
+    static constexpr size_t Alignment { 64 };
+
+private:
+    std::vector<unsigned char> storage;
+    unsigned char* base { nullptr };
+    size_t capacity { 0 };
+    size_t used { 0 };
+};
+
+}
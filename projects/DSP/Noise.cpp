@@ -0,0 +1,160 @@
+#include "Noise.h"
+
+#include <algorithm>
+
+namespace DSP
+{
+
+namespace
+{
+
+// Signed 32 bit integer to float from -1 to 1
+constexpr float IntScale { 1.f / 2147483648.f };
+
+// Splitmix32 step, spreads consecutive seeds to unrelated lane states
+uint32_t splitMix(uint32_t& seed)
+{
+    uint32_t z { seed += 0x9e3779b9u };
+    z = (z ^ (z >> 16)) * 0x85ebca6bu;
+    z = (z ^ (z >> 13)) * 0xc2b2ae35u;
+    return z ^ (z >> 16);
+}
+
+// Output gains keeping pink and brown peaks within about +-1, like white
+constexpr float PinkGain { 0.11f };
+constexpr float BrownGain { 3.5f };
+
+}
+
+Noise::Noise(uint32_t seed, Colour newColour) :
+    colour { newColour }
+{
+    setSeed(seed);
+}
+
+Noise::~Noise()
+{
+}
+
+void Noise::setSeed(uint32_t seed)
+{
+    for (unsigned int v = 0; v < Lanes; ++v)
+    {
+        const uint32_t s { splitMix(seed) };
+        state[v] = s != 0 ? s : 0x6d2b79f5u;
+    }
+
+    whiteIndex = Lanes;
+    clear();
+}
+
+void Noise::clear()
+{
+    std::fill(pinkState, pinkState + PinkStates, 0.f);
+    brownState = 0.f;
+}
+
+void Noise::process(float* output, unsigned int numSamples)
+{
+    generateWhite(output, numSamples);
+
+    switch (colour)
+    {
+    case Pink:
+        filterPink(output, numSamples);
+        break;
+
+    case Brown:
+        filterBrown(output, numSamples);
+        break;
+
+    default: break;
+    }
+}
+
+float Noise::process()
+{
+    float noise { 0.f };
+    process(&noise, 1);
+    return noise;
+}
+
+void Noise::setColour(Colour newColour)
+{
+    if (newColour != colour)
+        clear();
+
+    colour = newColour;
+}
+
+void Noise::generate(float* output)
+{
+    for (unsigned int v = 0; v < Lanes; ++v)
+    {
+        uint32_t x { state[v] };
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        state[v] = x;
+        output[v] = static_cast<float>(static_cast<int32_t>(x)) * IntScale;
+    }
+}
+
+void Noise::generateWhite(float* output, unsigned int numSamples)
+{
+    unsigned int n { 0 };
+
+    // Rest of the previous step first
+    while (n < numSamples && whiteIndex < Lanes)
+        output[n++] = whiteBuffer[whiteIndex++];
+
+    // Whole steps straight to the output
+    for (; n + Lanes <= numSamples; n += Lanes)
+        generate(output + n);
+
+    // Partial step, the remainder is kept for the next call
+    if (n < numSamples)
+    {
+        generate(whiteBuffer);
+        whiteIndex = 0;
+        while (n < numSamples)
+            output[n++] = whiteBuffer[whiteIndex++];
+    }
+}
+
+void Noise::filterPink(float* output, unsigned int numSamples)
+{
+    // Sum of one pole filters with staggered poles, plus a direct and a one sample delayed white path
+    float b0 { pinkState[0] }, b1 { pinkState[1] }, b2 { pinkState[2] }, b3 { pinkState[3] };
+    float b4 { pinkState[4] }, b5 { pinkState[5] }, b6 { pinkState[6] };
+
+    for (unsigned int n = 0; n < numSamples; ++n)
+    {
+        const float white { output[n] };
+        b0 = 0.99886f * b0 + white * 0.0555179f;
+        b1 = 0.99332f * b1 + white * 0.0750759f;
+        b2 = 0.96900f * b2 + white * 0.1538520f;
+        b3 = 0.86650f * b3 + white * 0.3104856f;
+        b4 = 0.55000f * b4 + white * 0.5329522f;
+        b5 = -0.7616f * b5 - white * 0.0168980f;
+        output[n] = PinkGain * (b0 + b1 + b2 + b3 + b4 + b5 + b6 + white * 0.5362f);
+        b6 = white * 0.115926f;
+    }
+
+    pinkState[0] = b0; pinkState[1] = b1; pinkState[2] = b2; pinkState[3] = b3;
+    pinkState[4] = b4; pinkState[5] = b5; pinkState[6] = b6;
+}
+
+void Noise::filterBrown(float* output, unsigned int numSamples)
+{
+    // Leaky integrator, the leak keeps it from drifting away
+    float b { brownState };
+    for (unsigned int n = 0; n < numSamples; ++n)
+    {
+        b = (b + 0.02f * output[n]) * (1.f / 1.02f);
+        output[n] = BrownGain * b;
+    }
+    brownState = b;
+}
+
+}
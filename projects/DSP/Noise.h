@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+
+namespace DSP
+{
+
+// Noise source for synth voices
+// White noise comes from 8 xorshift32 generators run side by side, one SIMD lane each,
+// so every step produces 8 samples. Pink and brown noise are filtered from it.
+// The sequence only depends on the seed, so voices seeded differently are uncorrelated
+// and a voice always renders the same noise for the same seed.
+class Noise
+{
+public:
+    enum Colour : unsigned int
+    {
+        White = 0, // flat spectrum
+        Pink,      // -3dB per octave, Paul Kellet's filter, within 0.05dB above 10Hz at 44.1kHz
+        Brown      // -6dB per octave, leaky integrator
+    };
+
+    Noise(uint32_t seed = 0, Colour colour = White);
+    ~Noise();
+
+    // No copy semantics
+    Noise(const Noise&) = delete;
+    const Noise& operator=(const Noise&) = delete;
+
+    // No move semantics
+    Noise(Noise&&) = delete;
+    const Noise& operator=(Noise&&) = delete;
+
+    // Restart the sequence from a seed and clear the colour filters
+    void setSeed(uint32_t seed);
+
+    // Clear the colour filters, the random sequence carries on
+    void clear();
+
+    // Process noise output for a buffer
+    void process(float* output, unsigned int numSamples);
+
+    // Process a single sample of noise, same sequence as the block flavour
+    float process();
+
+    // Select the noise colour
+    void setColour(Colour colour);
+
+    // White samples per generator step
+    static constexpr unsigned int Lanes { 8 };
+
+private:
+    Colour colour { White };
+
+    // One xorshift32 state per lane, never 0
+    uint32_t state[Lanes] {};
+
+    // Last step of white noise, consumed sample by sample
+    float whiteBuffer[Lanes] {};
+    unsigned int whiteIndex { Lanes };
+
+    // Colour filter states
+    static constexpr unsigned int PinkStates { 7 };
+    float pinkState[PinkStates] {};
+    float brownState { 0.f };
+
+    // Write the next step of white noise
+    void generate(float* output);
+
+    // Write white noise, continuing the sequence across calls
+    void generateWhite(float* output, unsigned int numSamples);
+
+    void filterPink(float* output, unsigned int numSamples);
+    void filterBrown(float* output, unsigned int numSamples);
+};
+
+}
@@ -1,10 +1,68 @@
 #include "Oscillator.h"
+#include "FastMath.h"
 #include <algorithm>
 #include <cmath>
 
 namespace DSP
 {
 
+namespace
+{
+
+// Samples per DPW kernel pass, sized for the stack scratch buffer
+constexpr unsigned int ChunkSize { 64 };
+
+// The top 24 bits of the phase convert exactly to float
+constexpr float PhaseScale { 1.f / 16777216.f };
+constexpr double PhaseRange { 4294967296.0 };
+
+// Sine flavour of the Sin waveform
+constexpr FastMath::Quality SinQuality { FastMath::Fast };
+
+// Calls fn(n, x) for the two samples around every wrap of a phase accumulator within a block,
+// x being the distance to the wrap in samples, from -1 to 0 before it and from 0 to 1 after it
+// Wrap positions are computed directly, so samples away from discontinuities are never visited
+// Corrections only depend on the sample's own phase, so they add up across block boundaries
+template<typename Fn>
+void forEachWrap(uint32_t start, uint32_t inc, unsigned int numSamples, Fn&& fn)
+{
+    if (inc == 0)
+        return;
+
+    constexpr uint64_t Cycle { 1ull << 32 };
+    const uint64_t step { inc };
+
+    // First sample past a wrap, where the phase is below the increment
+    uint64_t m { start < inc ? 0 : (Cycle - start + step - 1) / step };
+    while (m <= numSamples)
+    {
+        const uint32_t phase { start + static_cast<uint32_t>(m) * inc };
+        const float x { static_cast<float>(phase) / static_cast<float>(inc) };
+
+        if (m < numSamples)
+            fn(static_cast<unsigned int>(m), x);
+        if (m > 0)
+            fn(static_cast<unsigned int>(m - 1), x - 1.f);
+
+        m += (Cycle - phase + step - 1) / step;
+    }
+}
+
+// Two sample PolyBLEP residual of a unit step, x in samples from the step
+inline float polyBlep(float x)
+{
+    return x < 0.f ? 0.5f * (x + 1.f) * (x + 1.f) : -0.5f * (1.f - x) * (1.f - x);
+}
+
+// Two sample PolyBLAMP residual of a unit slope change, the integral of polyBlep
+inline float polyBlamp(float x)
+{
+    const float a { 1.f - std::fabs(x) };
+    return a * a * a * (1.f / 6.f);
+}
+
+}
+
 Oscillator::Oscillator()
 {
 }
@@ -18,78 +76,98 @@ void Oscillator::prepare(double newSampleRate)
     sampleRate = newSampleRate;
 
     // update phase increment for new sample rate
-    phaseInc = static_cast<float>(1.0 / sampleRate) * frequency;
+    phaseInc = static_cast<uint32_t>(std::round(static_cast<double>(frequency) / sampleRate * PhaseRange));
 
     differentiatorCoeff = static_cast<float>(sampleRate) / (4.f * frequency * (1.f - frequency / static_cast<float>(sampleRate)));
 
     // reset states
-    phaseState = 0.f;
+    phaseState = 0;
     differentiatorState = 0.f;
 }
 
 void Oscillator::process(float* output, unsigned int numSamples)
 {
-    for (unsigned int n = 0; n < numSamples; ++n)
+    switch (type)
     {
-        switch (type)
-        {
-        case Sin:
-            output[n] = std::sin(static_cast<float>(2.0 * M_PI) * phaseState);
-            break;
+    case Sin:
+        processSin(output, numSamples);
+        break;
 
-        case TriAliased:
-            output[n] = 4.f * std::fabs(phaseState - 0.5f) - 1.f;
-            break;
+    case TriAliased:
+        processTriAliased(output, numSamples);
+        break;
+
+    case SawAliased:
+        processSawAliased(output, numSamples);
+        break;
+
+    case TriAA:
+        processTriAA(output, numSamples);
+        break;
 
-        case SawAliased:
-            output[n] = 2.f * phaseState - 1.f;
-            break;
+    case SawAA:
+        processSawAA(output, numSamples);
+        break;
 
-        case TriAA:
-            output[n] = dpwTri();
-            break;
+    case SawBLEP:
+        processSawBLEP(output, numSamples);
+        break;
 
-        case SawAA:
-            output[n] = dpwSaw();
-            break;
+    case SquareBLEP:
+        processPulseBLEP(output, numSamples, 1u << 31);
+        break;
 
-        default: break;
-        }
+    case PulseBLEP:
+        processPulseBLEP(output, numSamples, pulseWidth);
+        break;
 
-        phaseState = std::fmod(phaseState + phaseInc, 1.f);
+    case TriBLAMP:
+        processTriBLAMP(output, numSamples);
+        break;
+
+    default: break;
     }
 }
 
 float Oscillator::process()
 {
+    // The band-limited kernels handle a single sample like any block
+    if (type >= SawBLEP)
+    {
+        float osc { 0.f };
+        process(&osc, 1);
+        return osc;
+    }
+
+    const float phase { static_cast<float>(phaseState >> 8) * PhaseScale };
     float osc { 0.f };
 
     switch (type)
     {
     case Sin:
-        osc = std::sin(static_cast<float>(2.0 * M_PI) * phaseState);
+        osc = FastMath::sinCycles<SinQuality>(phase);
         break;
 
     case TriAliased:
-        osc = 4.f * std::fabs(phaseState - 0.5f) - 1.f;
+        osc = 4.f * std::fabs(phase - 0.5f) - 1.f;
         break;
 
     case SawAliased:
-        osc = 2.f * phaseState - 1.f;
+        osc = 2.f * phase - 1.f;
         break;
 
     case TriAA:
-        osc = dpwTri();
+        osc = dpwTri(phase);
         break;
 
     case SawAA:
-        osc = dpwSaw();
+        osc = dpwSaw(phase);
         break;
 
     default: break;
     }
 
-    phaseState = std::fmod(phaseState + phaseInc, 1.f);
+    phaseState += phaseInc;
 
     return osc;
 }
@@ -98,7 +176,7 @@ void Oscillator::setFrequency(float freqHz)
 {
     frequency = std::clamp(freqHz, 0.1f, 10000.f);
 
-    phaseInc = static_cast<float>(1.0 / sampleRate) * frequency;
+    phaseInc = static_cast<uint32_t>(std::round(static_cast<double>(frequency) / sampleRate * PhaseRange));
     differentiatorCoeff = static_cast<float>(sampleRate) / (4.f * frequency * (1.f - frequency / static_cast<float>(sampleRate)));
 }
 
@@ -107,14 +185,155 @@ void Oscillator::setType(OscType newType)
     type = newType;
 
     // reset states
-    phaseState = 0.f;
+    phaseState = 0;
     differentiatorState = 0.f;
 }
 
-float Oscillator::dpwSaw()
+void Oscillator::setPulseWidth(float width)
+{
+    pulseWidth = static_cast<uint32_t>(static_cast<double>(std::clamp(width, 0.01f, 0.99f)) * PhaseRange);
+}
+
+void Oscillator::fillPhases(float* phases, unsigned int numSamples)
+{
+    const uint32_t start { phaseState };
+    const uint32_t inc { phaseInc };
+    for (unsigned int n = 0; n < numSamples; ++n)
+        phases[n] = static_cast<float>((start + inc * n) >> 8) * PhaseScale;
+
+    phaseState = start + inc * numSamples;
+}
+
+void Oscillator::processSin(float* output, unsigned int numSamples)
+{
+    fillPhases(output, numSamples);
+    FastMath::sinCycles<SinQuality>(output, output, numSamples);
+}
+
+void Oscillator::processTriAliased(float* output, unsigned int numSamples)
+{
+    fillPhases(output, numSamples);
+    for (unsigned int n = 0; n < numSamples; ++n)
+        output[n] = 4.f * std::fabs(output[n] - 0.5f) - 1.f;
+}
+
+void Oscillator::processSawAliased(float* output, unsigned int numSamples)
+{
+    fillPhases(output, numSamples);
+    for (unsigned int n = 0; n < numSamples; ++n)
+        output[n] = 2.f * output[n] - 1.f;
+}
+
+void Oscillator::processTriAA(float* output, unsigned int numSamples)
+{
+    const float coeff { differentiatorCoeff };
+    float shape[ChunkSize];
+
+    for (unsigned int offset = 0; offset < numSamples; offset += ChunkSize)
+    {
+        const unsigned int chunk { std::min(ChunkSize, numSamples - offset) };
+        float* out { output + offset };
+
+        // Integrated square wave, a parabola per half cycle
+        fillPhases(shape, chunk);
+        for (unsigned int n = 0; n < chunk; ++n)
+        {
+            const float bipolar { 2.f * shape[n] - 1.f };
+            shape[n] = std::copysign(1.f, bipolar) * (1.f - bipolar * bipolar);
+        }
+
+        // diffierentiator - clip above 0.f to about spike
+        out[0] = std::fmin(shape[0] - differentiatorState, 0.f);
+        for (unsigned int n = 1; n < chunk; ++n)
+            out[n] = std::fmin(shape[n] - shape[n - 1], 0.f);
+        differentiatorState = shape[chunk - 1];
+
+        for (unsigned int n = 0; n < chunk; ++n)
+            out[n] = 2.f * (out[n] * coeff) + 1.f;
+    }
+}
+
+void Oscillator::processSawAA(float* output, unsigned int numSamples)
+{
+    const float coeff { differentiatorCoeff };
+    float shape[ChunkSize];
+
+    for (unsigned int offset = 0; offset < numSamples; offset += ChunkSize)
+    {
+        const unsigned int chunk { std::min(ChunkSize, numSamples - offset) };
+        float* out { output + offset };
+
+        // Integrated saw, a parabola
+        fillPhases(shape, chunk);
+        for (unsigned int n = 0; n < chunk; ++n)
+        {
+            const float bipolar { 2.f * shape[n] - 1.f };
+            shape[n] = bipolar * bipolar;
+        }
+
+        // diffierentiator
+        out[0] = (shape[0] - differentiatorState) * coeff;
+        for (unsigned int n = 1; n < chunk; ++n)
+            out[n] = (shape[n] - shape[n - 1]) * coeff;
+        differentiatorState = shape[chunk - 1];
+    }
+}
+
+void Oscillator::processSawBLEP(float* output, unsigned int numSamples)
+{
+    const uint32_t start { phaseState };
+    processSawAliased(output, numSamples);
+
+    // Falling step of 2 at the wrap
+    forEachWrap(start, phaseInc, numSamples, [output] (unsigned int n, float x)
+    {
+        output[n] -= 2.f * polyBlep(x);
+    });
+}
+
+void Oscillator::processPulseBLEP(float* output, unsigned int numSamples, uint32_t width)
+{
+    const uint32_t start { phaseState };
+    const uint32_t inc { phaseInc };
+    for (unsigned int n = 0; n < numSamples; ++n)
+        output[n] = (start + inc * n) < width ? 1.f : -1.f;
+    phaseState = start + inc * numSamples;
+
+    // Rising step of 2 at the wrap, falling step of 2 at the pulse width
+    forEachWrap(start, inc, numSamples, [output] (unsigned int n, float x)
+    {
+        output[n] += 2.f * polyBlep(x);
+    });
+
+    forEachWrap(start - width, inc, numSamples, [output] (unsigned int n, float x)
+    {
+        output[n] -= 2.f * polyBlep(x);
+    });
+}
+
+void Oscillator::processTriBLAMP(float* output, unsigned int numSamples)
+{
+    const uint32_t start { phaseState };
+    processTriAliased(output, numSamples);
+
+    // Slope changes by 8 per cycle at the corners, scaled to per sample
+    const float slopeChange { 8.f * static_cast<float>(static_cast<double>(phaseInc) / PhaseRange) };
+
+    forEachWrap(start, phaseInc, numSamples, [output, slopeChange] (unsigned int n, float x)
+    {
+        output[n] -= slopeChange * polyBlamp(x);
+    });
+
+    forEachWrap(start - (1u << 31), phaseInc, numSamples, [output, slopeChange] (unsigned int n, float x)
+    {
+        output[n] += slopeChange * polyBlamp(x);
+    });
+}
+
+float Oscillator::dpwSaw(float phase)
 {
     // unipolar to bipolar
-    float bipolar = 2.f * phaseState - 1.f;
+    float bipolar = 2.f * phase - 1.f;
 
     // power of 2
     bipolar *= bipolar;
@@ -127,10 +346,10 @@ float Oscillator::dpwSaw()
     return output * differentiatorCoeff;
 }
 
-float Oscillator::dpwTri()
+float Oscillator::dpwTri(float phase)
 {
     // unipolar to bipolar
-    float bipolar = 2.f * phaseState - 1.f;
+    float bipolar = 2.f * phase - 1.f;
 
     // power of 2
     float parabola = bipolar * bipolar;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 namespace DSP
 {
 
@@ -12,7 +14,11 @@ public:
         TriAliased,
         SawAliased,
         TriAA,
-        SawAA
+        SawAA,
+        SawBLEP,    // PolyBLEP saw
+        SquareBLEP, // PolyBLEP square
+        PulseBLEP,  // PolyBLEP pulse, width set by setPulseWidth
+        TriBLAMP    // PolyBLAMP triangle
     };
 
     Oscillator();
@@ -27,6 +33,7 @@ public:
     void prepare(double sampleRate);
 
     // Process oscillator output for a buffer
+    // The waveform is selected once per call, each one has its own block kernel
     void process(float* output, unsigned int numSamples);
 
     // Process a single sample of the oscillator
@@ -38,22 +45,42 @@ public:
     // Select the waveform type
     void setType(OscType type);
 
+    // Set the pulse width of the PulseBLEP waveform, as a fraction of the cycle
+    void setPulseWidth(float width);
+
 private:
     double sampleRate { 48000.0 };
 
     float frequency { 1.f };
     OscType type { Sin };
 
-    float phaseState { 0.f };
-    float phaseInc { 0.f };
+    // Phase in cycles as 32 bit fixed point, wraps around for free
+    uint32_t phaseState { 0 };
+    uint32_t phaseInc { 0 };
 
     float differentiatorState { 0.f };
     float differentiatorCoeff { 0.f };
 
+    // Pulse width as a phase, in the same fixed point as the phase
+    uint32_t pulseWidth { 1u << 31 };
+
+    // Write the phase of the next samples in cycles, from 0 to 1, and advance it
+    void fillPhases(float* phases, unsigned int numSamples);
+
+    // Block kernels
+    void processSin(float* output, unsigned int numSamples);
+    void processTriAliased(float* output, unsigned int numSamples);
+    void processSawAliased(float* output, unsigned int numSamples);
+    void processTriAA(float* output, unsigned int numSamples);
+    void processSawAA(float* output, unsigned int numSamples);
+    void processSawBLEP(float* output, unsigned int numSamples);
+    void processPulseBLEP(float* output, unsigned int numSamples, uint32_t width);
+    void processTriBLAMP(float* output, unsigned int numSamples);
+
     // DPW methods
 
-    float dpwTri();
-    float dpwSaw();
+    float dpwTri(float phase);
+    float dpwSaw(float phase);
 };
 
 }
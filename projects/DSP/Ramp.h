@@ -12,8 +12,15 @@ public:
     // Default ramp time of 50ms
     static constexpr F DefaultRampTime { static_cast<F>(0.05) };
 
-    Ramp(F rampTimeSec) :
-        rampTime { std::fmax(rampTimeSec, minRampTime) }
+    enum Mode : unsigned int
+    {
+        Linear = 0,  // constant per-sample increment
+        Exponential  // constant per-sample multiplier, for positive values such as gains
+    };
+
+    Ramp(F rampTimeSec, Mode rampMode = Linear) :
+        rampTime { std::fmax(rampTimeSec, minRampTime) },
+        mode { rampMode }
     { }
 
     ~Ramp() { }
@@ -38,22 +45,50 @@ public:
         sampleRate = newSampleRate;
         if (skipRamp)
             setTarget(skipRampToValue, true);
-        else
-            setTarget(targetValue);
+        else if (!dbPending)
+        {
+            // Restart any ongoing ramp with the new sample rate
+            remainingSteps = 0;
+            startRamp(targetValue, false);
+        }
     }
 
     // Set the target value to the ramp
     // optionally allowing to skip the ramp
     void setTarget(F newTargetValue, bool skipRamp = false)
     {
-        if (std::abs(newTargetValue - currentValue) > minDelta)
+        dbPending = false;
+        skipPending = false;
+        targetIsDb = false;
+        startRamp(newTargetValue, skipRamp);
+    }
+
+    // Set the target value in dB, converted to linear once the ramp starts,
+    // so repeated calls from parameter callbacks cost no pow
+    void setTargetDb(F newTargetDb, bool skipRamp = false)
+    {
+        if (!skipRamp && targetIsDb && newTargetDb == targetDb)
+            return;
+
+        targetDb = newTargetDb;
+        targetIsDb = true;
+        dbPending = true;
+        skipPending = skipPending || skipRamp;
+        pending = true;
+    }
+
+    // Set ramp mode, an ongoing ramp restarts towards its target with the new mode
+    void setMode(Mode newMode)
+    {
+        if (newMode == mode)
+            return;
+
+        mode = newMode;
+        if (remainingSteps > 0)
         {
-            targetValue = newTargetValue;
-            rampStep = (targetValue - currentValue) / static_cast<F>(sampleRate * rampTime);
+            remainingSteps = 0;
+            startRamp(targetValue, false);
         }
-
-        if (skipRamp)
-            currentValue = targetValue = newTargetValue;
     }
 
     // Set new ramp time
@@ -65,12 +100,7 @@ public:
     // Apply summing ramp to a single sample in-place
     void applySum(F* buffers, unsigned int numChannels)
     {
-        const F targetDelta { std::fabs(targetValue - currentValue) };
-        if ((targetDelta > std::fabs(static_cast<F>(2) * rampStep)) && (std::fabs(rampStep) > minDelta))
-            currentValue += rampStep;
-        else
-            currentValue = targetValue;
-
+        advance();
         for (unsigned int ch = 0; ch < numChannels; ++ch)
             buffers[ch] += currentValue;
     }
@@ -78,44 +108,41 @@ public:
     // Apply summing ramp to an audio buffer in-place
     void applySum(F* const* buffers, unsigned int numChannels, unsigned int numSamples)
     {
-        for (unsigned int n = 0; n < numSamples; ++n)
+        applyBlock(numSamples,
+        [&] (unsigned int n, F value)
         {
-            const F targetDelta { std::fabs(targetValue - currentValue) };
-            if ((targetDelta > std::fabs(static_cast<F>(2) * rampStep)) && (std::fabs(rampStep) > minDelta))
-                currentValue += rampStep;
-            else
-                currentValue = targetValue;
-
             for (unsigned int ch = 0; ch < numChannels; ++ch)
-                buffers[ch][n] += currentValue;
-        }
+                buffers[ch][n] += value;
+        },
+        [&] (unsigned int start, unsigned int end, F value)
+        {
+            for (unsigned int ch = 0; ch < numChannels; ++ch)
+                for (unsigned int n = start; n < end; ++n)
+                    buffers[ch][n] += value;
+        });
     }
 
     // Apply summing ramp to an audio buffer out-of-place
     void applySum(F* const* output, const F* const* input, unsigned int numChannels, unsigned int numSamples)
     {
-        for (unsigned int n = 0; n < numSamples; ++n)
+        applyBlock(numSamples,
+        [&] (unsigned int n, F value)
         {
-            const F targetDelta { std::fabs(targetValue - currentValue) };
-            if ((targetDelta > std::fabs(static_cast<F>(2) * rampStep)) && (std::fabs(rampStep) > minDelta))
-                currentValue += rampStep;
-            else
-                currentValue = targetValue;
-
             for (unsigned int ch = 0; ch < numChannels; ++ch)
-                output[ch][n] = currentValue + input[ch][n];
-        }
+                output[ch][n] = value + input[ch][n];
+        },
+        [&] (unsigned int start, unsigned int end, F value)
+        {
+            for (unsigned int ch = 0; ch < numChannels; ++ch)
+                for (unsigned int n = start; n < end; ++n)
+                    output[ch][n] = value + input[ch][n];
+        });
     }
 
     // Apply gain ramp to an audio buffer in-place for single sample
     void applyGain(F* buffers, unsigned int numChannels)
     {
-        const F targetDelta { std::fabs(targetValue - currentValue) };
-        if ((targetDelta > std::fabs(static_cast<F>(2) * rampStep)) && (std::fabs(rampStep) > minDelta))
-            currentValue += rampStep;
-        else
-            currentValue = targetValue;
-
+        advance();
         for (unsigned int ch = 0; ch < numChannels; ++ch)
             buffers[ch] *= currentValue;
     }
@@ -123,58 +150,184 @@ public:
     // Apply gain ramp to an audio buffer in-place
     void applyGain(F* const* buffers, unsigned int numChannels, unsigned int numSamples)
     {
-        for (unsigned int n = 0; n < numSamples; ++n)
+        applyBlock(numSamples,
+        [&] (unsigned int n, F value)
         {
-            const F targetDelta { std::fabs(targetValue - currentValue) };
-            if ((targetDelta > std::fabs(static_cast<F>(2) * rampStep)) && (std::fabs(rampStep) > minDelta))
-                currentValue += rampStep;
-            else
-                currentValue = targetValue;
-
             for (unsigned int ch = 0; ch < numChannels; ++ch)
-                buffers[ch][n] *= currentValue;
-        }
+                buffers[ch][n] *= value;
+        },
+        [&] (unsigned int start, unsigned int end, F value)
+        {
+            for (unsigned int ch = 0; ch < numChannels; ++ch)
+                for (unsigned int n = start; n < end; ++n)
+                    buffers[ch][n] *= value;
+        });
     }
 
     // Apply gain ramp to an audio buffer out-of-place
     void applyGain(F* const* output, const F* const* input, unsigned int numChannels, unsigned int numSamples)
     {
-        for (unsigned int n = 0; n < numSamples; ++n)
+        applyBlock(numSamples,
+        [&] (unsigned int n, F value)
         {
-            const F targetDelta{ std::fabs(targetValue - currentValue) };
-            if ((targetDelta > std::fabs(static_cast<F>(2) * rampStep)) && (std::fabs(rampStep) > minDelta))
-                currentValue += rampStep;
-            else
-                currentValue = targetValue;
-
             for (unsigned int ch = 0; ch < numChannels; ++ch)
-                output[ch][n] = currentValue * input[ch][n];
-        }
+                output[ch][n] = value * input[ch][n];
+        },
+        [&] (unsigned int start, unsigned int end, F value)
+        {
+            for (unsigned int ch = 0; ch < numChannels; ++ch)
+                for (unsigned int n = start; n < end; ++n)
+                    output[ch][n] = value * input[ch][n];
+        });
     }
 
     float getNext()
     {
-        const F targetDelta { std::fabs(targetValue - currentValue) };
-        if ((targetDelta > std::fabs(static_cast<F>(2) * rampStep)) && (std::fabs(rampStep) > minDelta))
-            currentValue += rampStep;
-        else
-            currentValue = targetValue;
-
+        advance();
         return currentValue;
     }
 
+    // True while the ramp has not reached its target
+    bool isRamping() const noexcept { return remainingSteps > 0; }
+
     // Minimum ramp time in secondes
     static constexpr F minRampTime { static_cast<F>(1e-3) }; // 1ms
 
     // Minimun absolute differente between target and current value
     static constexpr F minDelta { static_cast<F>(1e-9) };
 
+    // Exponential ramps start from and head to at least this value, -120dB
+    // A ramp to zero still lands exactly on zero on its last step
+    static constexpr F minExpValue { static_cast<F>(1e-6) };
+
 private:
     double sampleRate { 48000.0 };
     F rampTime;
+    Mode mode { Linear };
+
+    // Per-sample increment, or multiplier in exponential mode
     F rampStep { static_cast<F>(0) };
     F targetValue { static_cast<F>(0) };
     F currentValue { static_cast<F>(0) };
+
+    // Samples left until the target is reached, zero when steady
+    unsigned int remainingSteps { 0 };
+
+    // Work deferred from the setters to the first processed sample
+    bool pending { false };
+    bool stepPending { false };
+    bool dbPending { false };
+    bool skipPending { false };
+
+    // Last dB target, repeated dB targets are ignored
+    F targetDb { static_cast<F>(0) };
+    bool targetIsDb { false };
+
+    void startRamp(F newTargetValue, bool skipRamp)
+    {
+        if (skipRamp || std::abs(newTargetValue - currentValue) <= minDelta)
+        {
+            currentValue = targetValue = newTargetValue;
+            rampStep = static_cast<F>(mode == Exponential ? 1 : 0);
+            remainingSteps = 0;
+            stepPending = false;
+            return;
+        }
+
+        // Already heading there
+        if (newTargetValue == targetValue && remainingSteps > 0)
+            return;
+
+        // The ramp always takes the full ramp time from the current value
+        targetValue = newTargetValue;
+        remainingSteps = static_cast<unsigned int>(std::fmax(std::round(sampleRate * static_cast<double>(rampTime)), 1.0));
+
+        if (mode == Exponential)
+        {
+            // The multiplier needs a pow, computed once the ramp starts
+            stepPending = true;
+            pending = true;
+        }
+        else
+        {
+            stepPending = false;
+            rampStep = (targetValue - currentValue) / static_cast<F>(remainingSteps);
+        }
+    }
+
+    void resolvePending()
+    {
+        pending = false;
+
+        if (dbPending)
+        {
+            dbPending = false;
+            const bool skipRamp { skipPending };
+            skipPending = false;
+            startRamp(std::pow(static_cast<F>(10), static_cast<F>(0.05) * targetDb), skipRamp);
+        }
+
+        if (stepPending)
+        {
+            stepPending = false;
+            currentValue = std::fmax(currentValue, minExpValue);
+            const F to { std::fmax(targetValue, minExpValue) };
+            rampStep = std::pow(to / currentValue, static_cast<F>(1) / static_cast<F>(remainingSteps));
+        }
+    }
+
+    // Single sample step, the last step lands exactly on the target
+    void advance()
+    {
+        if (pending)
+            resolvePending();
+
+        if (remainingSteps > 0)
+        {
+            if (--remainingSteps == 0)
+                currentValue = targetValue;
+            else if (mode == Exponential)
+                currentValue *= rampStep;
+            else
+                currentValue += rampStep;
+        }
+    }
+
+    // Split a block into a ramping segment, processed sample by sample,
+    // and a constant segment, processed as a plain loop the compiler can vectorise
+    template<typename RampFn, typename ConstantFn>
+    void applyBlock(unsigned int numSamples, RampFn&& rampFn, ConstantFn&& constantFn)
+    {
+        if (pending)
+            resolvePending();
+
+        const unsigned int rampSamples { remainingSteps < numSamples ? remainingSteps : numSamples };
+        remainingSteps -= rampSamples;
+
+        // The sample landing on the target is part of the constant segment
+        const unsigned int steps { (rampSamples > 0 && remainingSteps == 0) ? rampSamples - 1 : rampSamples };
+        if (mode == Exponential)
+        {
+            for (unsigned int n = 0; n < steps; ++n)
+            {
+                currentValue *= rampStep;
+                rampFn(n, currentValue);
+            }
+        }
+        else
+        {
+            for (unsigned int n = 0; n < steps; ++n)
+            {
+                currentValue += rampStep;
+                rampFn(n, currentValue);
+            }
+        }
+
+        if (remainingSteps == 0)
+            currentValue = targetValue;
+
+        constantFn(steps, numSamples, currentValue);
+    }
 };
 
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "LFO.h"
+
 namespace DSP
 {
 
@@ -41,10 +43,12 @@ private:
     // modulation type variable
     ModType modType { Sin };
 
-    // Phase state of the oscillators
-    // goes from "0.f" to "2.f * M_PI"
-    float phaseState[2] { 0.f, 0.f };
-    float phaseInc { 0.f };
+    // Modulation oscillator, quadrature between L and R channels
+    LFO lfo;
+
+    // Scratch buffer for the modulation block
+    static constexpr unsigned int SubBlockSize { 64 };
+    float lfoBuffer[LFO::MaxChannels][SubBlockSize] {};
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,177 @@
+#include "Saturation.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace DSP
+{
+
+namespace
+{
+
+// Below this input difference the antialiased output falls back to the curve at the midpoint
+constexpr double AntialiasingTolerance { 1e-5 };
+
+// log(cosh(x)), written to avoid overflow for large inputs
+double logCosh(double x)
+{
+    const double absX { std::fabs(x) };
+    return absX + std::log1p(std::exp(-2.0 * absX)) - M_LN2;
+}
+
+}
+
+Saturation::Saturation(Mode newMode, unsigned int maxNumChannels) :
+    mode { newMode },
+    previousInput(maxNumChannels, 0.0),
+    previousAntiderivative(maxNumChannels, 0.0)
+{
+}
+
+Saturation::~Saturation()
+{
+}
+
+void Saturation::clear()
+{
+    std::fill(previousInput.begin(), previousInput.end(), 0.0);
+    std::fill(previousAntiderivative.begin(), previousAntiderivative.end(), 0.0);
+}
+
+void Saturation::prepare(unsigned int maxNumChannels)
+{
+    previousInput.resize(maxNumChannels);
+    previousAntiderivative.resize(maxNumChannels);
+    clear();
+}
+
+void Saturation::process(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples)
+{
+    numChannels = std::min(numChannels, static_cast<unsigned int>(previousInput.size()));
+    for (unsigned int ch = 0; ch < numChannels; ++ch)
+    {
+        if (antialiasing)
+            processAntialiased(output[ch], input[ch], ch, numSamples);
+        else
+            processCurve(output[ch], input[ch], numSamples);
+    }
+}
+
+void Saturation::setMode(Mode newMode)
+{
+    mode = newMode;
+}
+
+void Saturation::setAntialiasing(bool enabled)
+{
+    if (enabled && !antialiasing)
+    {
+        // Start from the current input history being silence
+        clear();
+    }
+
+    antialiasing = enabled;
+}
+
+void Saturation::processExact(float* output, const float* input, unsigned int numSamples)
+{
+    for (unsigned int n = 0; n < numSamples; ++n)
+        output[n] = std::tanh(input[n]);
+}
+
+void Saturation::processAccurate(float* output, const float* input, unsigned int numSamples)
+{
+    // Odd rational approximation, the result saturates to +-1 within float precision at the clip point
+    const float clip { 7.90531110763549805f };
+    for (unsigned int n = 0; n < numSamples; ++n)
+    {
+        const float x { std::clamp(input[n], -clip, clip) };
+        const float x2 { x * x };
+
+        float p { -2.76076847742355e-16f };
+        p = p * x2 + 2.00018790482477e-13f;
+        p = p * x2 - 8.60467152213735e-11f;
+        p = p * x2 + 5.12229709037114e-08f;
+        p = p * x2 + 1.48572235717979e-05f;
+        p = p * x2 + 6.37261928875436e-04f;
+        p = p * x2 + 4.89352455891786e-03f;
+
+        float q { 1.19825839466702e-06f };
+        q = q * x2 + 1.18534705686654e-04f;
+        q = q * x2 + 2.26843463243900e-03f;
+        q = q * x2 + 4.89352518554385e-03f;
+
+        output[n] = x * p / q;
+    }
+}
+
+void Saturation::processBalanced(float* output, const float* input, unsigned int numSamples)
+{
+    // Clip point chosen to minimise the max error, the output is clamped as the curve overshoots 1
+    const float clip { 3.46f };
+    for (unsigned int n = 0; n < numSamples; ++n)
+    {
+        const float x { std::clamp(input[n], -clip, clip) };
+        const float x2 { x * x };
+
+        const float p { x * (945.f + x2 * (105.f + x2)) };
+        const float q { 945.f + x2 * (420.f + x2 * 15.f) };
+
+        output[n] = std::clamp(p / q, -1.f, 1.f);
+    }
+}
+
+void Saturation::processFast(float* output, const float* input, unsigned int numSamples)
+{
+    // Reaches exactly +-1 with zero slope at the clip point
+    const float clip { 3.f };
+    for (unsigned int n = 0; n < numSamples; ++n)
+    {
+        const float x { std::clamp(input[n], -clip, clip) };
+        const float x2 { x * x };
+
+        output[n] = x * (27.f + x2) / (27.f + 9.f * x2);
+    }
+}
+
+void Saturation::processCurve(float* output, const float* input, unsigned int numSamples) const
+{
+    switch (mode)
+    {
+        case Exact: processExact(output, input, numSamples); break;
+        case Accurate: processAccurate(output, input, numSamples); break;
+        case Balanced: processBalanced(output, input, numSamples); break;
+        case Fast: processFast(output, input, numSamples); break;
+    }
+}
+
+void Saturation::processAntialiased(float* output, const float* input, unsigned int channel, unsigned int numSamples)
+{
+    double x1 { previousInput[channel] };
+    double F1 { previousAntiderivative[channel] };
+
+    for (unsigned int n = 0; n < numSamples; ++n)
+    {
+        const double x0 { static_cast<double>(input[n]) };
+        const double F0 { logCosh(x0) };
+        const double dx { x0 - x1 };
+
+        if (std::fabs(dx) > AntialiasingTolerance)
+        {
+            output[n] = static_cast<float>((F0 - F1) / dx);
+        }
+        else
+        {
+            const float midpoint { static_cast<float>(0.5 * (x0 + x1)) };
+            processCurve(output + n, &midpoint, 1);
+        }
+
+        x1 = x0;
+        F1 = F0;
+    }
+
+    previousInput[channel] = x1;
+    previousAntiderivative[channel] = F1;
+}
+
+}
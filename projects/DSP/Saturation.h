@@ -0,0 +1,76 @@
+#pragma once
+
+#include <vector>
+
+namespace DSP
+{
+
+class Saturation
+{
+public:
+    // Tanh curve evaluation, max absolute errors measured against double precision tanh
+    enum Mode : unsigned int
+    {
+        Exact = 0, // std::tanh, reference
+        Accurate,  // odd 13/6 rational, max error 4e-7
+        Balanced,  // 5/4 Pade, clipped at +-3.46, max error 1e-3
+        Fast       // 3/2 Pade, clipped at +-3 with a smooth knee, max error 2.4e-2
+    };
+
+    // Main ctor
+    Saturation(Mode mode = Accurate, unsigned int maxNumChannels = 2);
+
+    // Dtor
+    ~Saturation();
+
+    // No copy sematics
+    Saturation(const Saturation&) = delete;
+    const Saturation& operator=(const Saturation&) = delete;
+
+    // No move semantics
+    Saturation(Saturation&&) = delete;
+    const Saturation& operator=(Saturation&&) = delete;
+
+    // Clear antialiasing states
+    void clear();
+
+    // Reallocate antialiasing states and clear them
+    void prepare(unsigned int maxNumChannels);
+
+    // Process audio buffers, supports in-place processing
+    // This method can be called with a lower number of channels than allocated
+    void process(float* const* output, const float* const* input, unsigned int numChannels, unsigned int numSamples);
+
+    // Set tanh evaluation mode
+    void setMode(Mode newMode);
+
+    // Enable first order antiderivative antialiasing (ADAA)
+    // The curve is computed from the exact antiderivative log(cosh(x)),
+    // the selected mode only applies when consecutive inputs are too close.
+    // This suppresses most of the aliasing of high drive settings without oversampling,
+    // at the cost of half a sample of delay and a slight high frequency roll-off
+    void setAntialiasing(bool enabled);
+
+    Mode getMode() const noexcept { return mode; }
+    bool getAntialiasing() const noexcept { return antialiasing; }
+
+    // Block kernels, branchless so the compiler can vectorise them
+    static void processExact(float* output, const float* input, unsigned int numSamples);
+    static void processAccurate(float* output, const float* input, unsigned int numSamples);
+    static void processBalanced(float* output, const float* input, unsigned int numSamples);
+    static void processFast(float* output, const float* input, unsigned int numSamples);
+
+private:
+    Mode mode { Accurate };
+    bool antialiasing { false };
+
+    // Previous input and its antiderivative per channel
+    // Kept in double precision as the antiderivative difference is ill-conditioned
+    std::vector<double> previousInput;
+    std::vector<double> previousAntiderivative;
+
+    void processCurve(float* output, const float* input, unsigned int numSamples) const;
+    void processAntialiased(float* output, const float* input, unsigned int channel, unsigned int numSamples);
+};
+
+}
@@ -0,0 +1,254 @@
+#pragma once
+
+#include <cmath>
+
+namespace DSP
+{
+
+// A fixed set of parameter ramps advanced together
+// Values, targets and steps are stored as arrays, one slot per smoother,
+// and every step advances all of them in a single branchless loop.
+// Each step is current * multiplier + increment, so linear and exponential
+// smoothers share the same loop, see Ramp for the single smoother flavour.
+// For control rate use, prepare with the control rate instead of the sample rate.
+template<typename F, unsigned int N>
+class SmootherBank
+{
+public:
+    // Default ramp time of 50ms
+    static constexpr F DefaultRampTime { static_cast<F>(0.05) };
+
+    enum Mode : unsigned int
+    {
+        Linear = 0,  // constant per-step increment
+        Exponential  // constant per-step multiplier, for positive values such as gains
+    };
+
+    SmootherBank(F rampTimeSec = DefaultRampTime)
+    {
+        for (unsigned int i = 0; i < N; ++i)
+            rampTime[i] = std::fmax(rampTimeSec, minRampTime);
+    }
+
+    ~SmootherBank() { }
+
+    // No copy semantics
+    SmootherBank(const SmootherBank&) = delete;
+    const SmootherBank& operator=(const SmootherBank&) = delete;
+
+    // No move semantics
+    SmootherBank(SmootherBank&&) = delete;
+    const SmootherBank& operator=(SmootherBank&&) = delete;
+
+    // Update sample rate of the ramp times, optionally skipping all smoothers to their targets
+    void prepare(double newSampleRate, bool skipRamp = false)
+    {
+        sampleRate = newSampleRate;
+        maxRemainingSteps = 0;
+        for (unsigned int i = 0; i < N; ++i)
+        {
+            // Restart any ongoing ramp with the new sample rate
+            remainingSteps[i] = 0;
+            if (dbPending[i])
+                skipPending[i] = skipPending[i] || skipRamp;
+            else
+                startRamp(i, targetValue[i], skipRamp);
+        }
+    }
+
+    // Set the target value of a smoother
+    // optionally allowing to skip the ramp
+    void setTarget(unsigned int index, F newTargetValue, bool skipRamp = false)
+    {
+        dbPending[index] = false;
+        skipPending[index] = false;
+        targetIsDb[index] = false;
+        startRamp(index, newTargetValue, skipRamp);
+    }
+
+    // Set the target value of a smoother in dB, the pow is deferred to the next step
+    // and repeated dB targets are ignored
+    void setTargetDb(unsigned int index, F newTargetDb, bool skipRamp = false)
+    {
+        if (!skipRamp && targetIsDb[index] && newTargetDb == targetDb[index])
+            return;
+
+        targetDb[index] = newTargetDb;
+        targetIsDb[index] = true;
+        dbPending[index] = true;
+        skipPending[index] = skipPending[index] || skipRamp;
+        pending = true;
+    }
+
+    // Set ramp time of a smoother, applies to the next target
+    void setRampTime(unsigned int index, F newRampTimeSec)
+    {
+        rampTime[index] = std::fmax(newRampTimeSec, minRampTime);
+    }
+
+    // Set ramp mode of a smoother, an ongoing ramp restarts towards its target with the new mode
+    void setMode(unsigned int index, Mode newMode)
+    {
+        if (newMode == mode[index])
+            return;
+
+        mode[index] = newMode;
+        remainingSteps[index] = 0;
+        startRamp(index, targetValue[index], false);
+    }
+
+    // Advance all smoothers by one step
+    // Returns the N current values, contiguous
+    const F* getNext()
+    {
+        if (pending)
+            resolvePending();
+
+        if (maxRemainingSteps > 0)
+        {
+            --maxRemainingSteps;
+            step();
+        }
+
+        return currentValue;
+    }
+
+    // Advance all smoothers by a block of steps
+    // Output is filled with numSteps control vectors of N values each, contiguous
+    void process(F* output, unsigned int numSteps)
+    {
+        if (pending)
+            resolvePending();
+
+        // Ramping part, stepped
+        const unsigned int rampSteps { maxRemainingSteps < numSteps ? maxRemainingSteps : numSteps };
+        maxRemainingSteps -= rampSteps;
+        for (unsigned int n = 0; n < rampSteps; ++n)
+        {
+            step();
+            for (unsigned int i = 0; i < N; ++i)
+                output[n * N + i] = currentValue[i];
+        }
+
+        // Steady part, copies of the current values
+        for (unsigned int n = rampSteps; n < numSteps; ++n)
+            for (unsigned int i = 0; i < N; ++i)
+                output[n * N + i] = currentValue[i];
+    }
+
+    // Current values without advancing, contiguous
+    const F* getCurrentValues() const noexcept { return currentValue; }
+
+    // True while any smoother has not reached its target
+    bool isRamping() const noexcept { return maxRemainingSteps > 0; }
+
+    // Minimum ramp time in secondes
+    static constexpr F minRampTime { static_cast<F>(1e-3) }; // 1ms
+
+    // Minimun absolute differente between target and current value
+    static constexpr F minDelta { static_cast<F>(1e-9) };
+
+    // Exponential ramps start from and head to at least this value, -120dB
+    static constexpr F minExpValue { static_cast<F>(1e-6) };
+
+    static constexpr unsigned int NumSmoothers { N };
+
+private:
+    double sampleRate { 48000.0 };
+
+    // Per smoother state, one slot each
+    F currentValue[N] {};
+    F targetValue[N] {};
+    F multiplier[N] {};
+    F increment[N] {};
+    unsigned int remainingSteps[N] {};
+
+    F rampTime[N] {};
+    Mode mode[N] {};
+
+    // Steps until every smoother is steady
+    unsigned int maxRemainingSteps { 0 };
+
+    // Work deferred from the setters to the next step
+    bool pending { false };
+    bool stepPending[N] {};
+    bool dbPending[N] {};
+    bool skipPending[N] {};
+    F targetDb[N] {};
+    bool targetIsDb[N] {};
+
+    void startRamp(unsigned int i, F newTargetValue, bool skipRamp)
+    {
+        if (skipRamp || std::abs(newTargetValue - currentValue[i]) <= minDelta)
+        {
+            currentValue[i] = targetValue[i] = newTargetValue;
+            multiplier[i] = static_cast<F>(1);
+            increment[i] = static_cast<F>(0);
+            remainingSteps[i] = 0;
+            stepPending[i] = false;
+            return;
+        }
+
+        // Already heading there
+        if (newTargetValue == targetValue[i] && remainingSteps[i] > 0)
+            return;
+
+        // The ramp always takes the full ramp time from the current value
+        targetValue[i] = newTargetValue;
+        remainingSteps[i] = static_cast<unsigned int>(std::fmax(std::round(sampleRate * static_cast<double>(rampTime[i])), 1.0));
+        maxRemainingSteps = remainingSteps[i] > maxRemainingSteps ? remainingSteps[i] : maxRemainingSteps;
+
+        if (mode[i] == Exponential)
+        {
+            // The multiplier needs a pow, computed on the next step
+            stepPending[i] = true;
+            pending = true;
+        }
+        else
+        {
+            stepPending[i] = false;
+            multiplier[i] = static_cast<F>(1);
+            increment[i] = (targetValue[i] - currentValue[i]) / static_cast<F>(remainingSteps[i]);
+        }
+    }
+
+    void resolvePending()
+    {
+        pending = false;
+
+        for (unsigned int i = 0; i < N; ++i)
+        {
+            if (dbPending[i])
+            {
+                dbPending[i] = false;
+                const bool skipRamp { skipPending[i] };
+                skipPending[i] = false;
+                startRamp(i, std::pow(static_cast<F>(10), static_cast<F>(0.05) * targetDb[i]), skipRamp);
+            }
+
+            if (stepPending[i])
+            {
+                stepPending[i] = false;
+                currentValue[i] = std::fmax(currentValue[i], minExpValue);
+                const F to { std::fmax(targetValue[i], minExpValue) };
+                multiplier[i] = std::pow(to / currentValue[i], static_cast<F>(1) / static_cast<F>(remainingSteps[i]));
+                increment[i] = static_cast<F>(0);
+            }
+        }
+    }
+
+    // Masked countdown, steady smoothers keep their value
+    // and the last step of each ramp lands exactly on its target
+    void step()
+    {
+        for (unsigned int i = 0; i < N; ++i)
+        {
+            const unsigned int steps { remainingSteps[i] };
+            const F next { currentValue[i] * multiplier[i] + increment[i] };
+            currentValue[i] = steps > 1 ? next : (steps == 1 ? targetValue[i] : currentValue[i]);
+            remainingSteps[i] = steps > 0 ? steps - 1 : 0;
+        }
+    }
+};
+
+}
@@ -18,52 +18,181 @@ void StateVariableFilter::prepare(double newSampleRate)
 {
     sampleRate = newSampleRate;
 
-    state0 = 0.f;
-    state1 = 0.f;
+    std::fill(state0, state0 + MaxChannels, 0.f);
+    std::fill(state1, state1 + MaxChannels, 0.f);
+
+    // Coefficients depend on the sample rate
+    cachedFreq = -1.f;
 }
 
 void StateVariableFilter::process(float* lpfOut, float* bpfOut, float* hpfOut, const float* audioIn, const float* freqIn, const float* resoIn, unsigned int numSamples)
 {
+    process(&lpfOut, &bpfOut, &hpfOut, &audioIn, freqIn, resoIn, 1, numSamples);
+}
+
+void StateVariableFilter::process(float* const* lpfOut, float* const* bpfOut, float* const* hpfOut, const float* const* audioIn, const float* freqIn, const float* resoIn, unsigned int numChannels, unsigned int numSamples)
+{
+    numChannels = std::min(numChannels, MaxChannels);
+
+    if (quality == FastMath::Exact)
+        processKernel<FastMath::Exact>(lpfOut, bpfOut, hpfOut, audioIn, freqIn, resoIn, numChannels, numSamples);
+    else
+        processKernel<FastMath::Fast>(lpfOut, bpfOut, hpfOut, audioIn, freqIn, resoIn, numChannels, numSamples);
+}
+
+void StateVariableFilter::setQuality(FastMath::Quality newQuality)
+{
+    if (newQuality != quality)
+        cachedFreq = -1.f;
+
+    quality = newQuality;
+}
+
+namespace
+{
+
+// Coefficients are computed for chunks of samples ahead of the filter loop
+constexpr unsigned int CoefficientChunk { 64 };
+
+bool isConstant(const float* input, unsigned int numSamples)
+{
+    bool constant { true };
+    for (unsigned int n = 1; n < numSamples; ++n)
+        constant &= input[n] == input[0];
+
+    return constant;
+}
+
+}
+
+template<FastMath::Quality Q>
+void StateVariableFilter::processKernel(float* const* lpfOut, float* const* bpfOut, float* const* hpfOut, const float* const* audioIn, const float* freqIn, const float* resoIn, unsigned int numChannels, unsigned int numSamples)
+{
+    if (numSamples == 0)
+        return;
+
+    // Constant controls, one set of coefficients for the whole block
+    if (isConstant(freqIn, numSamples) && isConstant(resoIn, numSamples))
+    {
+        if (freqIn[0] != cachedFreq || resoIn[0] != cachedReso)
+        {
+            computeCoefficients<Q>(cached, freqIn, resoIn, 1);
+            cachedFreq = freqIn[0];
+            cachedReso = resoIn[0];
+        }
+
+        const Coefficients<1> coeffs { cached };
+        processChannels(lpfOut, bpfOut, hpfOut, audioIn, coeffs, numChannels, 0, numSamples);
+        return;
+    }
+
+    // Modulated controls, the coefficients of a chunk first, then all channels over it
+    Coefficients<CoefficientChunk> coeffs;
+    for (unsigned int start = 0; start < numSamples; start += CoefficientChunk)
+    {
+        const unsigned int chunkSize { std::min(CoefficientChunk, numSamples - start) };
+        computeCoefficients<Q>(coeffs, freqIn + start, resoIn + start, chunkSize);
+        processChannels(lpfOut, bpfOut, hpfOut, audioIn, coeffs, numChannels, start, chunkSize);
+    }
+}
+
+template<unsigned int Size>
+void StateVariableFilter::processChannels(float* const* lpfOut, float* const* bpfOut, float* const* hpfOut, const float* const* audioIn, const Coefficients<Size>& coeffs, unsigned int numChannels, unsigned int offset, unsigned int numSamples)
+{
+    unsigned int ch { 0 };
+    for (; ch + 2 <= numChannels; ch += 2)
+        processLanes<2>(lpfOut, bpfOut, hpfOut, audioIn, coeffs, ch, offset, numSamples);
+
+    if (ch < numChannels)
+        processLanes<1>(lpfOut, bpfOut, hpfOut, audioIn, coeffs, ch, offset, numSamples);
+}
+
+template<unsigned int Lanes, unsigned int Size>
+void StateVariableFilter::processLanes(float* const* lpfOut, float* const* bpfOut, float* const* hpfOut, const float* const* audioIn, const Coefficients<Size>& coeffs, unsigned int firstChannel, unsigned int offset, unsigned int numSamples)
+{
+    float s0[Lanes];
+    float s1[Lanes];
+    float* lp[Lanes];
+    float* bp[Lanes];
+    float* hp[Lanes];
+    const float* x[Lanes];
+    for (unsigned int c = 0; c < Lanes; ++c)
+    {
+        s0[c] = state0[firstChannel + c];
+        s1[c] = state1[firstChannel + c];
+        lp[c] = lpfOut[firstChannel + c] + offset;
+        bp[c] = bpfOut[firstChannel + c] + offset;
+        hp[c] = hpfOut[firstChannel + c] + offset;
+        x[c] = audioIn[firstChannel + c] + offset;
+    }
+
+    for (unsigned int n = 0; n < numSamples; ++n)
+    {
+        const unsigned int i { Size > 1 ? n : 0 };
+        for (unsigned int c = 0; c < Lanes; ++c)
+            tick(s0[c], s1[c], x[c][n], coeffs, i, lp[c][n], bp[c][n], hp[c][n]);
+    }
+
+    for (unsigned int c = 0; c < Lanes; ++c)
+    {
+        state0[firstChannel + c] = s0[c];
+        state1[firstChannel + c] = s1[c];
+    }
+}
+
+template<FastMath::Quality Q, unsigned int Size>
+void StateVariableFilter::computeCoefficients(Coefficients<Size>& coeffs, const float* freqIn, const float* resoIn, unsigned int numSamples) const
+{
+    const float piOverFs { static_cast<float>(M_PI / sampleRate) };
+
     for (unsigned int n = 0; n < numSamples; ++n)
     {
         // 2R = 1 / Q
-        float twoR = 1.f / std::clamp(resoIn[n], 0.1f, 10.f);
+        const float twoR { 1.f / std::clamp(resoIn[n], 0.1f, 10.f) };
 
         // g = tan(pi * Fc / Fs)
-        float g = std::tan(static_cast<float>(M_PI / sampleRate) * std::clamp(freqIn[n], 20.f, 20000.f));
+        const float g { FastMath::tan<Q>(piOverFs * std::clamp(freqIn[n], 20.f, 20000.f)) };
 
         // g0 = 2R + g
-        float g0 = twoR + g;
+        const float g0 { twoR + g };
 
         // d = 1 / (1 + 2Rg + g^2)
-        float d = 1.f / (1.f + twoR * g + g * g);
+        const float d { 1.f / (1.f + twoR * g + g * g) };
 
         // hp = (x - s1 - g0 * s0) * d
-        float hp = (audioIn[n] - state1 - g0 * state0) * d;
-
-        // v0 = g * hp
-        float v0 = g * hp;
-
-        // bp = v0 + s0
-        float bp = v0 + state0;
-
-        // s0 = bp + v0
-        state0 = bp + v0;
+        // bp = g * hp + s0, s0' = 2 * bp - s0
+        // lp = g * bp + s1, s1' = 2 * lp - s1
+        // expanded in terms of x, s0 and s1
+        const float gd { g * d };
+        const float bpS0 { 1.f - gd * g0 };
+
+        coeffs.a00[n] = 2.f * bpS0 - 1.f;
+        coeffs.a01[n] = -2.f * gd;
+        coeffs.a10[n] = 2.f * g * bpS0;
+        coeffs.a11[n] = 1.f - 2.f * g * gd;
+        coeffs.b0[n] = 2.f * gd;
+        coeffs.b1[n] = 2.f * g * gd;
+        coeffs.d[n] = d;
+        coeffs.dg0[n] = d * g0;
+    }
+}
 
-        // v1 = g * bp
-        float v1 = g * bp;
+template<unsigned int Size>
+void StateVariableFilter::tick(float& s0, float& s1, float x, const Coefficients<Size>& coeffs, unsigned int i, float& lpfOut, float& bpfOut, float& hpfOut)
+{
+    // hp = (x - s1 - g0 * s0) * d
+    hpfOut = coeffs.d[i] * (x - s1) - coeffs.dg0[i] * s0;
 
-        // lp = v1 + s1
-        float lp = v1 + state1;
+    // s' = A s + b x, both states from the previous ones
+    const float next0 { coeffs.a00[i] * s0 + (coeffs.a01[i] * s1 + coeffs.b0[i] * x) };
+    const float next1 { coeffs.a11[i] * s1 + (coeffs.a10[i] * s0 + coeffs.b1[i] * x) };
 
-        // s1 = lp + v1
-        state1 = lp + v1;
+    // bp = (s0 + s0') / 2, lp = (s1 + s1') / 2
+    bpfOut = 0.5f * (s0 + next0);
+    lpfOut = 0.5f * (s1 + next1);
 
-        // write to output vectors
-        lpfOut[n] = lp;
-        bpfOut[n] = bp;
-        hpfOut[n] = hp;
-    }
+    s0 = next0;
+    s1 = next1;
 }
 
 }
@@ -1,8 +1,12 @@
 #pragma once
 
+#include "FastMath.h"
+
 namespace DSP
 {
 
+// Stereo-linked multichannel flavour: all channels share the freq and reso controls,
+// coefficients are computed once per sample for all of them and channel pairs advance together.
 class StateVariableFilter
 {
 public:
@@ -16,15 +20,78 @@ public:
 
     void prepare(double sampleRate);
 
+    // Process a single channel, channel 0 of the multichannel flavour
     void process(float* lpfOut, float* bpfOut, float* hpfOut,
                  const float* audioIn, const float* freqIn, const float* resoIn,
                  unsigned int numSamples);
 
+    // Process all channels with the same controls, up to MaxChannels
+    void process(float* const* lpfOut, float* const* bpfOut, float* const* hpfOut,
+                 const float* const* audioIn, const float* freqIn, const float* resoIn,
+                 unsigned int numChannels, unsigned int numSamples);
+
+    // Select how the cutoff warping tan is evaluated
+    void setQuality(FastMath::Quality newQuality);
+
+    static constexpr unsigned int MaxChannels { 8 };
+
 private:
     double sampleRate { 48000.0 };
+    FastMath::Quality quality { FastMath::Fast };
+
+    // Per channel state
+    float state0[MaxChannels] {};
+    float state1[MaxChannels] {};
+
+    // Coefficients for a run of samples, one array each
+    // The state update is written as a 2x2 matrix, so the recursion is only two multiply-adds deep
+    template<unsigned int Size>
+    struct Coefficients
+    {
+        float a00[Size]; // state to state
+        float a01[Size];
+        float a10[Size];
+        float a11[Size];
+        float b0[Size];  // input to state
+        float b1[Size];
+        float d[Size];   // high pass output, d and d * g0
+        float dg0[Size];
+    };
+
+    // Coefficients of the last block with constant controls,
+    // reused by the following ones while the controls stay the same
+    float cachedFreq { -1.f };
+    float cachedReso { -1.f };
+    Coefficients<1> cached {};
+
+    template<FastMath::Quality Q>
+    void processKernel(float* const* lpfOut, float* const* bpfOut, float* const* hpfOut,
+                       const float* const* audioIn, const float* freqIn, const float* resoIn,
+                       unsigned int numChannels, unsigned int numSamples);
+
+    // Coefficients for a run of controls, no state involved so the loop vectorises
+    template<FastMath::Quality Q, unsigned int Size>
+    void computeCoefficients(Coefficients<Size>& coeffs,
+                             const float* freqIn, const float* resoIn,
+                             unsigned int numSamples) const;
+
+    // Filter all channels over a run of samples, from offset, with coefficients
+    // for every sample of the run, or a single set when Size is 1
+    template<unsigned int Size>
+    void processChannels(float* const* lpfOut, float* const* bpfOut, float* const* hpfOut,
+                         const float* const* audioIn, const Coefficients<Size>& coeffs,
+                         unsigned int numChannels, unsigned int offset, unsigned int numSamples);
+
+    // Filter a group of channels side by side, their recursions overlap
+    template<unsigned int Lanes, unsigned int Size>
+    void processLanes(float* const* lpfOut, float* const* bpfOut, float* const* hpfOut,
+                      const float* const* audioIn, const Coefficients<Size>& coeffs,
+                      unsigned int firstChannel, unsigned int offset, unsigned int numSamples);
 
-    float state0 { 0.f };
-    float state1 { 0.f };
+    // Advance the filter by one sample, states in locals so stores to the outputs cannot alias them
+    template<unsigned int Size>
+    static void tick(float& s0, float& s1, float x, const Coefficients<Size>& coeffs, unsigned int i,
+                     float& lpfOut, float& bpfOut, float& hpfOut);
 };
 
 }
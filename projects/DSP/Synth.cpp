@@ -8,14 +8,27 @@ float convertMidiNoteToFreq(int MidiNote)
     return 440.f * std::pow(2.f, static_cast<float>(MidiNote - 69) / 12.f);
 }
 
-SynthVoice::SynthVoice()
+SynthVoice::SynthVoice(Synth& s, unsigned int voiceIndex) :
+    synth(s),
+    noise(voiceIndex),
+    envelopeLane(voiceIndex * NumEnvelopes)
 {
-    sawOsc.setType(Oscillator::SawAA);
+    jassert(voiceIndex < Synth::MaxVoices);
+
     triOsc.setType(Oscillator::TriAA);
-    sinOsc.setType(Oscillator::Sin);
 
-    vcaEnvGen.setAnalogStyle(false);
-    vcfEnvGen.setAnalogStyle(false);
+    filter.setQuality(MathQuality);
+
+    synth.envelopes.setAnalogStyle(envelopeLane + VCAEnv, false);
+    synth.envelopes.setAnalogStyle(envelopeLane + VCFEnv, false);
+
+    // Volumes fade evenly in dB
+    controls.setMode(SinOscVol, Controls::Exponential);
+    controls.setMode(TriOscVol, Controls::Exponential);
+    controls.setMode(SawOscVol, Controls::Exponential);
+    controls.setMode(NoiseVol, Controls::Exponential);
+    controls.setMode(OscVol, Controls::Exponential);
+    controls.setMode(OutputVol, Controls::Exponential);
 }
 
 SynthVoice::~SynthVoice()
@@ -24,105 +37,130 @@ SynthVoice::~SynthVoice()
 
 void SynthVoice::setOscSawVol(float dB, bool skipRamp)
 {
-    sawOscVolRamp.setTarget(std::pow(10.f, 0.05f * dB), skipRamp);
+    controls.setTargetDb(SawOscVol, dB, skipRamp);
 }
 
 void SynthVoice::setOscTriVol(float dB, bool skipRamp)
 {
-    triOscVolRamp.setTarget(std::pow(10.f, 0.05f * dB), skipRamp);
+    controls.setTargetDb(TriOscVol, dB, skipRamp);
 }
 
 void SynthVoice::setOscSinVol(float dB, bool skipRamp)
 {
-    sinOscVolRamp.setTarget(std::pow(10.f, 0.05f * dB), skipRamp);
+    controls.setTargetDb(SinOscVol, dB, skipRamp);
 }
 
 void SynthVoice::setOscVol(float dB, bool skipRamp)
 {
-    oscVolRamp.setTarget(std::pow(10.f, 0.05f * dB), skipRamp);
+    controls.setTargetDb(OscVol, dB, skipRamp);
+}
+
+void SynthVoice::setOscSawVoices(unsigned int numVoices)
+{
+    sawOsc.setVoices(numVoices);
+}
+
+void SynthVoice::setOscSawSpread(float norm)
+{
+    sawOsc.setSpread(std::clamp(norm, 0.f, 1.f));
+}
+
+void SynthVoice::setNoiseVol(float dB, bool skipRamp)
+{
+    // The exponential ramp lands exactly on 0, so the noise can be muted
+    if (dB <= NoiseOffDb)
+        controls.setTarget(NoiseVol, 0.f, skipRamp);
+    else
+        controls.setTargetDb(NoiseVol, dB, skipRamp);
+}
+
+void SynthVoice::setNoiseType(NoiseType type)
+{
+    noise.setColour(type == BROWN ? Noise::Brown : (type == PINK ? Noise::Pink : Noise::White));
 }
 
 void SynthVoice::setAttTimeVCA(float ms)
 {
-    vcaEnvGen.setAttackTime(ms);
+    synth.envelopes.setAttackTime(envelopeLane + VCAEnv, ms);
 }
 
 void SynthVoice::setDecayTimeVCA(float ms)
 {
-    vcaEnvGen.setDecayTime(ms);
+    synth.envelopes.setDecayTime(envelopeLane + VCAEnv, ms);
 }
 
 void SynthVoice::setSustainVCA(float norm)
 {
-    vcaEnvGen.setSustainLevel(std::clamp(norm, 0.f, 1.f));
+    synth.envelopes.setSustainLevel(envelopeLane + VCAEnv, std::clamp(norm, 0.f, 1.f));
 }
 
 void SynthVoice::setRelTimeVCA(float ms)
 {
-    vcaEnvGen.setReleaseTime(ms);
+    synth.envelopes.setReleaseTime(envelopeLane + VCAEnv, ms);
 }
 
 void SynthVoice::setAttTimeVCF(float ms)
 {
-    vcfEnvGen.setAttackTime(ms);
+    synth.envelopes.setAttackTime(envelopeLane + VCFEnv, ms);
 }
 
 void SynthVoice::setDecayTimeVCF(float ms)
 {
-    vcfEnvGen.setDecayTime(ms);
+    synth.envelopes.setDecayTime(envelopeLane + VCFEnv, ms);
 }
 
 void SynthVoice::setSustainVCF(float norm)
 {
-    vcfEnvGen.setSustainLevel(std::clamp(norm, 0.f, 1.f));
+    synth.envelopes.setSustainLevel(envelopeLane + VCFEnv, std::clamp(norm, 0.f, 1.f));
 }
 
 void SynthVoice::setRelTimeVCF(float ms)
 {
-    vcfEnvGen.setReleaseTime(ms);
+    synth.envelopes.setReleaseTime(envelopeLane + VCFEnv, ms);
 }
 
 void SynthVoice::setLFOFreqVCF(float Hz)
 {
     lfoFreq = std::fmax(Hz, 0.f);
-    lfoPhaseInc = static_cast<float>(2.0 * M_PI / sampleRate) * lfoFreq;
+    vcfLFO.setFrequency(lfoFreq);
 }
 
 void SynthVoice::setLFOTypeVCF(LFOType type)
 {
     lfoType = type;
+    vcfLFO.setWaveform(lfoType == TRI ? LFO::Tri : LFO::Sin);
 }
 
 void SynthVoice::setEnvAmountVCF(float bipolar, bool skipRamp)
 {
-    vcfEnvAmountRamp.setTarget(std::clamp(bipolar, -1.f, 1.f), skipRamp);
+    controls.setTarget(VCFEnvAmount, std::clamp(bipolar, -1.f, 1.f), skipRamp);
 }
 
 void SynthVoice::setLFOAmountVCF(float bipolar, bool skipRamp)
 {
-    vcfLFOAmountRamp.setTarget(std::clamp(bipolar, -1.f, 1.f), skipRamp);
+    controls.setTarget(VCFLFOAmount, std::clamp(bipolar, -1.f, 1.f), skipRamp);
 }
 
 void SynthVoice::setFilterCutoff(float Hz, bool skipRamp)
 {
-    vcfFreqRamp.setTarget(std::clamp(Hz, MinFreqHz, MaxFreqHz), skipRamp);
+    controls.setTarget(VCFFreq, std::clamp(Hz, MinFreqHz, MaxFreqHz), skipRamp);
 }
 
 void SynthVoice::setFilterReso(float Q, bool skipRamp)
 {
-    vcfResoRamp.setTarget(std::clamp(Q, MinReso, MaxReso), skipRamp);
+    controls.setTarget(VCFReso, std::clamp(Q, MinReso, MaxReso), skipRamp);
 }
 
 void SynthVoice::setFilterType(FilterType type, bool skipRamp)
 {
-    vcfLPFRamp.setTarget(type == LPF ? 1.f : 0.f, skipRamp);
-    vcfBPFRamp.setTarget(type == BPF ? 1.f : 0.f, skipRamp);
-    vcfHPFRamp.setTarget(type == HPF ? 1.f : 0.f, skipRamp);
+    controls.setTarget(VCFLPF, type == LPF ? 1.f : 0.f, skipRamp);
+    controls.setTarget(VCFBPF, type == BPF ? 1.f : 0.f, skipRamp);
+    controls.setTarget(VCFHPF, type == HPF ? 1.f : 0.f, skipRamp);
 }
 
 void SynthVoice::setOutputVol(float dB, bool skipRamp)
 {
-    outputVolRamp.setTarget(std::pow(10.f, 0.05f * dB), skipRamp);
+    controls.setTargetDb(OutputVol, dB, skipRamp);
 }
 
 
@@ -136,8 +174,8 @@ void SynthVoice::startNote(int midiNoteNumber, float newVelocity, juce::Synthesi
     sinOsc.setFrequency(convertMidiNoteToFreq(midiNoteNumber));
     triOsc.setFrequency(convertMidiNoteToFreq(midiNoteNumber));
     sawOsc.setFrequency(convertMidiNoteToFreq(midiNoteNumber));
-    vcaEnvGen.start();
-    vcfEnvGen.start();
+    synth.envelopes.start(envelopeLane + VCAEnv);
+    synth.envelopes.start(envelopeLane + VCFEnv);
 
     velocity = newVelocity;
     voiceStarted = true;
@@ -145,8 +183,8 @@ void SynthVoice::startNote(int midiNoteNumber, float newVelocity, juce::Synthesi
 
 void SynthVoice::stopNote(float velocity, bool allowTailOff)
 {
-    vcaEnvGen.end();
-    vcfEnvGen.end();
+    synth.envelopes.end(envelopeLane + VCAEnv);
+    synth.envelopes.end(envelopeLane + VCFEnv);
 
     if (!allowTailOff)
         clearCurrentNote();
@@ -162,6 +200,8 @@ void SynthVoice::controllerMoved(int controllerNumber, int newControllerValue)
 
 void SynthVoice::renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
 {
+    jassert(numSamples <= static_cast<int>(MaxControlInterval));
+
     const auto newSampleRate { getSampleRate() };
     if (sampleRate != newSampleRate)
     {
@@ -170,88 +210,168 @@ void SynthVoice::renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int sta
         sinOsc.prepare(sampleRate);
         triOsc.prepare(sampleRate);
         sawOsc.prepare(sampleRate);
-        vcaEnvGen.prepare(sampleRate);
-        vcfEnvGen.prepare(sampleRate);
         filter.prepare(sampleRate);
-        sinOscVolRamp.prepare(sampleRate);
-        triOscVolRamp.prepare(sampleRate);
-        sawOscVolRamp.prepare(sampleRate);
-        oscVolRamp.prepare(sampleRate);
-        outputVolRamp.prepare(sampleRate);
-        vcfEnvAmountRamp.prepare(sampleRate);
-        vcfLFOAmountRamp.prepare(sampleRate);
-        vcfFreqRamp.prepare(sampleRate);
-        vcfResoRamp.prepare(sampleRate);
-        vcfLPFRamp.prepare(sampleRate);
-        vcfBPFRamp.prepare(sampleRate);
-        vcfHPFRamp.prepare(sampleRate);
-
-        lfoPhaseInc = static_cast<float>(2.0 * M_PI / sampleRate) * std::fmax(lfoFreq, 0.f);
+        prepareControlRate();
+    }
+    else if (controlInterval != synth.controlInterval)
+    {
+        prepareControlRate();
     }
 
-    for (int i = 0; i < numSamples; ++i)
+    float sin[MaxControlInterval];
+    float tri[MaxControlInterval];
+    float saw[MaxControlInterval];
+    float noiseOut[MaxControlInterval];
+    float oscOut[MaxControlInterval];
+    float lpfOut[MaxControlInterval];
+    float bpfOut[MaxControlInterval];
+    float hpfOut[MaxControlInterval];
+    float out[MaxControlInterval];
+    float mod[NumModulations][MaxControlInterval];
+
+    const unsigned int blockSize { static_cast<unsigned int>(numSamples) };
+
+    // Control ticks fall where the synth advanced the envelopes, a control period may span several sub-blocks
+    const float* env { &synth.envelopeLevels[0][envelopeLane] };
+    unsigned int controlSamplesLeft { synth.controlSamplesLeft };
+    for (unsigned int n = 0; n < blockSize; ++n)
     {
-        const auto sin { sinOsc.process() };
-        const auto tri { triOsc.process() };
-        const auto saw { sawOsc.process() };
+        if (controlSamplesLeft == 0)
+        {
+            updateModulation(env);
+            env += Synth::Envelopes::NumEnvelopes;
+            controlSamplesLeft = controlInterval;
+        }
+        --controlSamplesLeft;
 
-        float vcaEnv { 0.f };
-        vcaEnvGen.process(&vcaEnv, 1);
+        for (unsigned int i = 0; i < NumModulations; ++i)
+        {
+            modulation[i] += modulationInc[i];
+            mod[i][n] = modulation[i];
+        }
+    }
 
-        float vcfEnv { 0.f };
-        vcfEnvGen.process(&vcfEnv, 1);
+    sinOsc.process(sin, blockSize);
+    triOsc.process(tri, blockSize);
+    float* sawOut[1] { saw };
+    sawOsc.process(sawOut, 1, blockSize);
+    noise.process(noiseOut, blockSize);
 
-        const auto sinVol { sinOscVolRamp.getNext() };
-        const auto triVol { triOscVolRamp.getNext() };
-        const auto sawVol { sawOscVolRamp.getNext() };
-        const auto oscVol { oscVolRamp.getNext() };
+    for (unsigned int n = 0; n < blockSize; ++n)
+        oscOut[n] = sin[n] * mod[SinGain][n] + tri[n] * mod[TriGain][n] + saw[n] * mod[SawGain][n] + noiseOut[n] * mod[NoiseGain][n];
 
-        const auto vcfEnvAmout { vcfEnvAmountRamp.getNext() };
-        const auto vcfLFOAmount { vcfLFOAmountRamp.getNext() };
+    filter.process(lpfOut, bpfOut, hpfOut, oscOut, mod[FilterFreq], mod[FilterReso], blockSize);
 
-        const auto vcfFreq { vcfFreqRamp.getNext() };
-        const auto vcfReso { vcfResoRamp.getNext() };
-        const auto vcfLPF { vcfLPFRamp.getNext() };
-        const auto vcfBPF { vcfBPFRamp.getNext() };
-        const auto vcfHPF { vcfHPFRamp.getNext() };
+    for (unsigned int n = 0; n < blockSize; ++n)
+        out[n] = lpfOut[n] * mod[LPFGain][n] + bpfOut[n] * mod[BPFGain][n] + hpfOut[n] * mod[HPFGain][n];
 
-        const auto outputVol { outputVolRamp.getNext() };
+    for (int ch = 0; ch < outputBuffer.getNumChannels(); ++ch)
+        outputBuffer.addFrom(ch, startSample, out, numSamples);
 
-        // Process LFO acording to mod type
-        float lfo { 0.f };
-        switch (lfoType)
-        {
-        case TRI:
-            lfo = std::fabs((lfoPhaseState - static_cast<float>(M_PI)) / static_cast<float>(M_PI));
-            break;
+    if (voiceStarted && synth.envelopes.isOff(envelopeLane + VCAEnv) && synth.envelopes.isOff(envelopeLane + VCFEnv))
+    {
+        voiceStarted = false;
+        clearCurrentNote();
+    }
+}
 
-        case SIN:
-            lfo = 0.5f + 0.5f * std::sin(lfoPhaseState);
-            break;
-        }
-        lfoPhaseState = std::fmod(lfoPhaseState + lfoPhaseInc, static_cast<float>(2 * M_PI));
+void SynthVoice::prepareControlRate()
+{
+    controlInterval = synth.controlInterval;
+    const double controlRate { sampleRate / static_cast<double>(controlInterval) };
 
-        const auto oscOut { (sin * sinVol + tri * triVol + saw * sawVol) * oscVol * vcaEnv * velocity };
-        const auto freqMod { std::clamp(vcfEnv * vcfEnvAmout + vcfLFOAmount * lfo, -1.f, 1.f) };
-        const auto freq { std::clamp(FreqModRange * (std::pow(2.f, freqMod) - 1.f) + vcfFreq, MinFreqHz, MaxFreqHz) };
+    controls.prepare(controlRate);
 
-        float lpfOut { 0.f };
-        float bpfOut { 0.f };
-        float hpfOut { 0.f };
-        filter.process(&lpfOut, &bpfOut, &hpfOut, &oscOut, &freq, &vcfReso, 1);
+    vcfLFO.setFrequency(lfoFreq);
+    vcfLFO.prepare(controlRate);
+}
 
-        const auto out { (vcfLPF * lpfOut + vcfBPF * bpfOut + vcfHPF * hpfOut) * outputVol };
-        for (int ch = 0; ch < outputBuffer.getNumChannels(); ++ch)
-        {
-            outputBuffer.addSample(ch, startSample + i, out);
-        }
+void SynthVoice::updateModulation(const float* env)
+{
+    const float vcaEnv { env[VCAEnv] };
+    const float vcfEnv { env[VCFEnv] };
+
+    // All smoothed controls advance together
+    const float* c { controls.getNext() };
+
+    // Process LFO, unipolar
+    float lfo { 0.f };
+    vcfLFO.process(&lfo, 1);
+    lfo = 0.5f + 0.5f * lfo;
+
+    const auto oscGain { c[OscVol] * vcaEnv * velocity };
+    const auto freqMod { std::clamp(vcfEnv * c[VCFEnvAmount] + c[VCFLFOAmount] * lfo, -1.f, 1.f) };
+
+    float target[NumModulations];
+    target[SinGain] = c[SinOscVol] * oscGain;
+    target[TriGain] = c[TriOscVol] * oscGain;
+    target[SawGain] = c[SawOscVol] * oscGain;
+    target[NoiseGain] = c[NoiseVol] * oscGain;
+    target[FilterFreq] = std::clamp(FreqModRange * (FastMath::exp2<MathQuality>(freqMod) - 1.f) + c[VCFFreq], MinFreqHz, MaxFreqHz);
+    target[FilterReso] = c[VCFReso];
+    target[LPFGain] = c[VCFLPF] * c[OutputVol];
+    target[BPFGain] = c[VCFBPF] * c[OutputVol];
+    target[HPFGain] = c[VCFHPF] * c[OutputVol];
+
+    // Ramp from where the last one ended, so rounding does not accumulate across periods
+    const float invInterval { 1.f / static_cast<float>(controlInterval) };
+    for (unsigned int i = 0; i < NumModulations; ++i)
+        modulationInc[i] = (target[i] - modulation[i]) * invInterval;
+}
 
-        if (voiceStarted && vcaEnvGen.isOff() && vcfEnvGen.isOff())
-        {
-            voiceStarted = false;
-            clearCurrentNote();
-        }
+
+Synth::Synth()
+{
+}
+
+Synth::~Synth()
+{
+}
+
+void Synth::setControlRate(SynthVoice::ControlRate rate)
+{
+    const unsigned int newInterval { rate == SynthVoice::EVERY_32 ? 32u : (rate == SynthVoice::EVERY_16 ? 16u : (rate == SynthVoice::EVERY_8 ? 8u : 1u)) };
+    if (newInterval == controlInterval)
+        return;
+
+    controlInterval = newInterval;
+
+    // Envelopes run at the control rate, prepared once the sample rate is known
+    // Voices follow on their next rendered sub-block
+    if (getSampleRate() > 0.0)
+        prepareControlRate();
+}
+
+void Synth::setCurrentPlaybackSampleRate(double newSampleRate)
+{
+    juce::Synthesiser::setCurrentPlaybackSampleRate(newSampleRate);
+    prepareControlRate();
+}
+
+void Synth::renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples)
+{
+    // Sub-blocks of at most MaxControlInterval samples
+    unsigned int offset { 0 };
+    while (offset < static_cast<unsigned int>(numSamples))
+    {
+        const unsigned int blockSize { std::min(SynthVoice::MaxControlInterval, static_cast<unsigned int>(numSamples) - offset) };
+
+        // The envelopes of all voices advance once per control tick in the sub-block
+        const unsigned int numTicks { controlSamplesLeft < blockSize ? (blockSize - controlSamplesLeft - 1u) / controlInterval + 1u : 0u };
+        envelopes.process(&envelopeLevels[0][0], numTicks);
+
+        for (auto* voice : voices)
+            voice->renderNextBlock(outputAudio, startSample + static_cast<int>(offset), static_cast<int>(blockSize));
+
+        controlSamplesLeft = controlSamplesLeft + numTicks * controlInterval - blockSize;
+        offset += blockSize;
     }
 }
 
+void Synth::prepareControlRate()
+{
+    envelopes.prepare(getSampleRate() / static_cast<double>(controlInterval));
+    controlSamplesLeft = 0;
+}
+
 }
@@ -3,9 +3,14 @@
 #include <JuceHeader.h>
 
 #include "Oscillator.h"
-#include "EnvelopeGenerator.h"
+#include "WavetableOscillator.h"
+#include "UnisonOscillator.h"
+#include "Noise.h"
+#include "LFO.h"
+#include "EnvelopeBank.h"
 #include "StateVariableFilter.h"
-#include "Ramp.h"
+#include "SmootherBank.h"
+#include "FastMath.h"
 
 namespace DSP
 {
@@ -17,10 +22,14 @@ public:
     bool appliesToChannel(int) override { return true; }
 };
 
+class Synth;
+
 class SynthVoice : public juce::SynthesiserVoice
 {
 public:
-    SynthVoice();
+    // The voice index seeds the noise source, so every voice has its own noise,
+    // and selects the voice envelopes in the envelope bank shared by the synth
+    SynthVoice(Synth& synth, unsigned int voiceIndex);
     ~SynthVoice();
 
     enum LFOType : unsigned int
@@ -29,6 +38,13 @@ public:
         TRI
     };
 
+    enum NoiseType : unsigned int
+    {
+        WHITE = 0,
+        PINK,
+        BROWN
+    };
+
     enum FilterType : unsigned int
     {
         LPF = 0,
@@ -36,6 +52,15 @@ public:
         HPF,
     };
 
+    // How often envelopes, LFO and smoothed controls are evaluated
+    enum ControlRate : unsigned int
+    {
+        AUDIO_RATE = 0,
+        EVERY_8,
+        EVERY_16,
+        EVERY_32
+    };
+
     SynthVoice(const SynthVoice&) = delete;
     SynthVoice(SynthVoice&&) = delete;
     const SynthVoice& operator=(const SynthVoice&) = delete;
@@ -49,6 +74,13 @@ public:
     void setOscSinVol(float dB, bool skipRamp);
     void setOscVol(float dB, bool skipRamp);
 
+    void setOscSawVoices(unsigned int numVoices);
+    void setOscSawSpread(float norm);
+
+    // At or below NoiseOffDb the noise gain is exactly 0
+    void setNoiseVol(float dB, bool skipRamp);
+    void setNoiseType(NoiseType type);
+
     void setAttTimeVCA(float ms);
     void setDecayTimeVCA(float ms);
     void setSustainVCA(float norm);
@@ -77,6 +109,9 @@ public:
     void stopNote(float velocity, bool allowTailOff) override;
     void pitchWheelMoved(int newPitchWheelValue) override;
     void controllerMoved(int controllerNumber, int newControllerValue) override;
+
+    // Rendered by the synth in sub-blocks of at most MaxControlInterval samples,
+    // reading the envelopes it advanced for the control ticks in them
     void renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples) override;
 
     static constexpr float MaxFreqHz { 20000.f };
@@ -87,41 +122,139 @@ public:
 
     static constexpr float FreqModRange { 10000.f };
 
+    static constexpr float NoiseOffDb { -60.f };
+
+    // Evaluation of the per sample filter frequency modulation and warping
+    static constexpr FastMath::Quality MathQuality { FastMath::Fast };
+
+    // Longest control period in samples, also the sub-block size the audio is rendered in
+    static constexpr unsigned int MaxControlInterval { 32 };
+
 private:
+    friend class Synth;
+
+    Synth& synth;
+
     double sampleRate { 1.0 };
 
     float lfoFreq { 1.f };
     float velocity { 1.f };
 
-    Oscillator sinOsc;
+    WavetableOscillator sinOsc { WavetableOscillator::Sin };
     Oscillator triOsc;
-    Oscillator sawOsc;
+    UnisonOscillator sawOsc;
+    Noise noise;
+
+    // Voice envelopes, offsets from the first lane of the voice in the shared envelope bank
+    enum Envelope : unsigned int
+    {
+        VCAEnv = 0,
+        VCFEnv,
+        NumEnvelopes
+    };
 
-    EnvelopeGenerator vcaEnvGen;
-    EnvelopeGenerator vcfEnvGen;
+    const unsigned int envelopeLane;
 
     StateVariableFilter filter;
 
-    LFOType lfoType;
-    float lfoPhaseState { 0.f };
-    float lfoPhaseInc { 0.f };
+    LFOType lfoType { SIN };
+    LFO vcfLFO;
+
+    // Smoothed controls, indices into the control vector
+    enum Control : unsigned int
+    {
+        SinOscVol = 0,
+        TriOscVol,
+        SawOscVol,
+        NoiseVol,
+        OscVol,
+        OutputVol,
+        VCFEnvAmount,
+        VCFLFOAmount,
+        VCFFreq,
+        VCFReso,
+        VCFLPF,
+        VCFBPF,
+        VCFHPF,
+        NumControls
+    };
+
+    using Controls = SmootherBank<float, NumControls>;
+    Controls controls;
+
+    // Audio rate modulation, evaluated every control period
+    // and ramped linearly from the previous values over the next one
+    enum Modulation : unsigned int
+    {
+        SinGain = 0,
+        TriGain,
+        SawGain,
+        NoiseGain,
+        FilterFreq,
+        FilterReso,
+        LPFGain,
+        BPFGain,
+        HPFGain,
+        NumModulations
+    };
+
+    float modulation[NumModulations] {};
+    float modulationInc[NumModulations] {};
 
-    Ramp<float> sinOscVolRamp;
-    Ramp<float> triOscVolRamp;
-    Ramp<float> sawOscVolRamp;
-    Ramp<float> oscVolRamp;
-    Ramp<float> outputVolRamp;
+    // Control interval the voice sources are prepared for, follows the synth
+    unsigned int controlInterval { 1 };
 
-    Ramp<float> vcfEnvAmountRamp;
-    Ramp<float> vcfLFOAmountRamp;
+    // Prepare the control rate sources for the current sample rate and control interval
+    void prepareControlRate();
 
-    Ramp<float> vcfFreqRamp;
-    Ramp<float> vcfResoRamp;
-    Ramp<float> vcfLPFRamp;
-    Ramp<float> vcfBPFRamp;
-    Ramp<float> vcfHPFRamp;
+    // Evaluate the control rate sources and start ramping the modulation to them
+    // The envelope levels are the voice lanes of the shared envelope bank
+    void updateModulation(const float* env);
 
     bool voiceStarted { false };
 };
 
+// Synthesiser sharing a single envelope bank between all its SynthVoices
+// Voices are rendered on common control ticks, and the envelopes of all of them
+// advance together once per tick, as one vector
+class Synth : public juce::Synthesiser
+{
+public:
+    Synth();
+    ~Synth();
+
+    Synth(const Synth&) = delete;
+    Synth(Synth&&) = delete;
+    const Synth& operator=(const Synth&) = delete;
+    const Synth& operator=(Synth&&) = delete;
+
+    // Running notes are cut when the control rate changes
+    void setControlRate(SynthVoice::ControlRate rate);
+
+    void setCurrentPlaybackSampleRate(double sampleRate) override;
+
+    static constexpr unsigned int MaxVoices { 8 };
+
+protected:
+    void renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples) override;
+
+private:
+    friend class SynthVoice;
+
+    // Envelopes of all the voices, NumEnvelopes lanes per voice
+    using Envelopes = EnvelopeBank<float, MaxVoices * SynthVoice::NumEnvelopes>;
+    Envelopes envelopes;
+
+    // Envelope levels at the control ticks of the sub-block being rendered, all lanes per tick
+    float envelopeLevels[SynthVoice::MaxControlInterval][Envelopes::NumEnvelopes] {};
+
+    unsigned int controlInterval { 1 };
+
+    // Samples until the next control tick, at the start of the sub-block being rendered
+    unsigned int controlSamplesLeft { 0 };
+
+    // Prepare the envelopes for the current sample rate and control interval
+    void prepareControlRate();
+};
+
 }
@@ -0,0 +1,240 @@
+#include "UnisonOscillator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace DSP
+{
+
+namespace
+{
+
+// Lanes per group, two SSE or NEON vectors, one AVX vector
+constexpr unsigned int LaneGroup { 8 };
+
+// The top 24 bits of the phase convert exactly to float
+constexpr float PhaseScale { 1.f / 16777216.f };
+constexpr double PhaseRange { 4294967296.0 };
+
+// Voice start phases follow the golden ratio sequence, evenly spread for any voice count
+constexpr double VoicePhaseStep { 0.618033988749895 };
+
+// Sum of the lanes as a fixed tree of pairwise adds, so it vectorises without reassociation
+template<unsigned int Lanes>
+inline float sumLanes(float* lanes)
+{
+    for (unsigned int width = Lanes / 2; width > 0; width /= 2)
+        for (unsigned int v = 0; v < width; ++v)
+            lanes[v] += lanes[v + width];
+
+    return lanes[0];
+}
+
+// Phase in cycles, from 0 to 1, of a 32 bit fixed point phase
+inline float toCycles(uint32_t phase)
+{
+    return static_cast<float>(static_cast<int32_t>(phase >> 8)) * PhaseScale;
+}
+
+// Two sample PolyBLEP residual of a unit rising step, for a phase t in cycles
+// invInc is the reciprocal of the phase increment, also in cycles
+// Both sides are clipped with abs instead of compares, so the lane loop has no branches
+inline float polyBlep(float t, float invInc)
+{
+    const float a { 1.f - t * invInc };         // 1 at the step, 0 one sample after it
+    const float b { 1.f + (t - 1.f) * invInc }; // 0 one sample before the step, 1 at it
+    const float after { 0.5f * (a + std::fabs(a)) };
+    const float before { 0.5f * (b + std::fabs(b)) };
+    return 0.5f * (before * before - after * after);
+}
+
+}
+
+UnisonOscillator::UnisonOscillator()
+{
+    updateDetune();
+    updateGains();
+    reset();
+}
+
+UnisonOscillator::~UnisonOscillator()
+{
+}
+
+void UnisonOscillator::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    updateIncrements();
+    reset();
+}
+
+void UnisonOscillator::reset()
+{
+    for (unsigned int v = 0; v < MaxVoices; ++v)
+    {
+        const double p { VoicePhaseStep * static_cast<double>(v) };
+        phase[v] = static_cast<uint32_t>((p - std::floor(p)) * PhaseRange);
+    }
+}
+
+void UnisonOscillator::process(float* const* output, unsigned int numChannels, unsigned int numSamples)
+{
+    numChannels = std::min(numChannels, MaxChannels);
+
+    if (numLanes <= LaneGroup)
+    {
+        if (waveform == Square)
+            processLanes<LaneGroup, Square>(output, numChannels, numSamples);
+        else
+            processLanes<LaneGroup, Saw>(output, numChannels, numSamples);
+    }
+    else
+    {
+        if (waveform == Square)
+            processLanes<MaxVoices, Square>(output, numChannels, numSamples);
+        else
+            processLanes<MaxVoices, Saw>(output, numChannels, numSamples);
+    }
+}
+
+float UnisonOscillator::process()
+{
+    float osc { 0.f };
+    float* out[1] { &osc };
+    process(out, 1, 1);
+    return osc;
+}
+
+void UnisonOscillator::setFrequency(float freqHz)
+{
+    frequency = std::clamp(freqHz, 0.1f, 10000.f);
+    updateIncrements();
+}
+
+void UnisonOscillator::setWaveform(Waveform newWaveform)
+{
+    waveform = newWaveform;
+}
+
+void UnisonOscillator::setVoices(unsigned int newNumVoices)
+{
+    numVoices = std::clamp(newNumVoices, 1u, MaxVoices);
+    numLanes = (numVoices + LaneGroup - 1) / LaneGroup * LaneGroup;
+    updateDetune();
+    updateGains();
+}
+
+void UnisonOscillator::setSpread(float newSpread)
+{
+    spread = std::clamp(newSpread, 0.f, 1.f);
+    updateDetune();
+}
+
+void UnisonOscillator::setStereoSpread(float newSpread)
+{
+    stereoSpread = std::clamp(newSpread, 0.f, 1.f);
+    updateGains();
+}
+
+void UnisonOscillator::updateDetune()
+{
+    // Voices evenly spaced in cents, symmetric around the centre frequency
+    for (unsigned int v = 0; v < MaxVoices; ++v)
+    {
+        const float position { numVoices > 1 ? 2.f * static_cast<float>(v) / static_cast<float>(numVoices - 1) - 1.f : 0.f };
+        detuneRatio[v] = std::exp2(spread * MaxDetuneCents * position / 1200.f);
+    }
+
+    updateIncrements();
+}
+
+void UnisonOscillator::updateIncrements()
+{
+    for (unsigned int v = 0; v < MaxVoices; ++v)
+    {
+        const double inc { static_cast<double>(frequency * detuneRatio[v]) / sampleRate };
+        phaseInc[v] = static_cast<uint32_t>(std::round(std::min(inc, 0.5) * PhaseRange));
+        invInc[v] = static_cast<float>(PhaseRange / static_cast<double>(std::max(phaseInc[v], 1u)));
+    }
+}
+
+void UnisonOscillator::updateGains()
+{
+    // Voice sum kept at a steady level regardless of the voice count
+    const float norm { 1.f / std::sqrt(static_cast<float>(numVoices)) };
+
+    for (unsigned int v = 0; v < MaxVoices; ++v)
+    {
+        if (v >= numVoices)
+        {
+            monoGain[v] = stereoGain[0][v] = stereoGain[1][v] = 0.f;
+            continue;
+        }
+
+        // Equal power pan following the detune, lowest voice to the left
+        const float position { numVoices > 1 ? 2.f * static_cast<float>(v) / static_cast<float>(numVoices - 1) - 1.f : 0.f };
+        const float angle { static_cast<float>(0.25 * M_PI) * (1.f + stereoSpread * position) };
+
+        monoGain[v] = norm;
+        stereoGain[0][v] = norm * std::cos(angle);
+        stereoGain[1][v] = norm * std::sin(angle);
+    }
+}
+
+template<unsigned int Lanes, UnisonOscillator::Waveform W>
+void UnisonOscillator::processLanes(float* const* output, unsigned int numChannels, unsigned int numSamples)
+{
+    const float* gains[MaxChannels] { monoGain, nullptr };
+    if (numChannels == 2)
+    {
+        gains[0] = stereoGain[0];
+        gains[1] = stereoGain[1];
+    }
+
+    // Lane state in locals, so stores to the output cannot alias it
+    alignas(64) uint32_t p[Lanes];
+    alignas(64) uint32_t inc[Lanes];
+    alignas(64) float inv[Lanes];
+    std::copy(phase, phase + Lanes, p);
+    std::copy(phaseInc, phaseInc + Lanes, inc);
+    std::copy(invInc, invInc + Lanes, inv);
+
+    alignas(64) float lanes[Lanes];
+    alignas(64) float weighted[Lanes];
+
+    for (unsigned int n = 0; n < numSamples; ++n)
+    {
+        // All voices advance together, one lane each
+        for (unsigned int v = 0; v < Lanes; ++v)
+        {
+            const float t { toCycles(p[v]) };
+
+            if constexpr (W == Square)
+            {
+                // Rising step at the wrap, falling step half a cycle later
+                const float sign { static_cast<float>(1 - 2 * static_cast<int32_t>(p[v] >> 31)) };
+                const float half { toCycles(p[v] + (1u << 31)) };
+                lanes[v] = sign + 2.f * polyBlep(t, inv[v]) - 2.f * polyBlep(half, inv[v]);
+            }
+            else
+            {
+                // Falling step at the wrap
+                lanes[v] = 2.f * t - 1.f - 2.f * polyBlep(t, inv[v]);
+            }
+
+            p[v] += inc[v];
+        }
+
+        for (unsigned int ch = 0; ch < numChannels; ++ch)
+        {
+            for (unsigned int v = 0; v < Lanes; ++v)
+                weighted[v] = lanes[v] * gains[ch][v];
+
+            output[ch][n] = sumLanes<Lanes>(weighted);
+        }
+    }
+
+    std::copy(p, p + Lanes, phase);
+}
+
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+
+namespace DSP
+{
+
+// Detuned unison oscillator, as used for supersaw sounds
+// All voices share one pitch and are detuned around it by the spread amount.
+// Voice states are stored as arrays, one SIMD lane per voice, and every sample
+// advances all lanes in one branchless loop before summing them with per voice gains.
+// Lanes are processed in groups of 8, so any voice count up to 8 costs the same.
+class UnisonOscillator
+{
+public:
+    // PolyBLEP band-limited waveforms
+    enum Waveform : unsigned int
+    {
+        Saw = 0,
+        Square
+    };
+
+    UnisonOscillator();
+    ~UnisonOscillator();
+
+    // No copy semantics
+    UnisonOscillator(const UnisonOscillator&) = delete;
+    const UnisonOscillator& operator=(const UnisonOscillator&) = delete;
+
+    // No move semantics
+    UnisonOscillator(UnisonOscillator&&) = delete;
+    const UnisonOscillator& operator=(UnisonOscillator&&) = delete;
+
+    // Update sample rate and reset phases
+    void prepare(double sampleRate);
+
+    // Reset voice phases, spread so voices do not start in sync
+    void reset();
+
+    // Process the sum of all voices
+    // A single channel gets the mono sum, two channels are panned by the stereo spread
+    void process(float* const* output, unsigned int numChannels, unsigned int numSamples);
+
+    // Process a single sample of the mono sum
+    float process();
+
+    // Set the centre frequency in Hz
+    void setFrequency(float freqHz);
+
+    // Select the waveform, the phases are kept
+    void setWaveform(Waveform waveform);
+
+    // Set number of voices
+    void setVoices(unsigned int numVoices);
+
+    // Set detune spread, 0 for all voices in unison, 1 for MaxDetuneCents on the outer voices
+    void setSpread(float spread);
+
+    // Set stereo spread, 0 for all voices centred, 1 for the outer voices hard panned
+    void setStereoSpread(float spread);
+
+    static constexpr unsigned int MaxVoices { 16 };
+    static constexpr unsigned int MaxChannels { 2 };
+    static constexpr float MaxDetuneCents { 50.f };
+
+private:
+    double sampleRate { 48000.0 };
+    float frequency { 440.f };
+    Waveform waveform { Saw };
+
+    unsigned int numVoices { 1 };
+    float spread { 0.f };
+    float stereoSpread { 0.f };
+
+    // Lanes processed per sample, numVoices rounded up to a multiple of 8
+    unsigned int numLanes { 8 };
+
+    // Per voice state, one lane each, unused lanes have zero gains
+    // Phases in cycles as 32 bit fixed point, wrap around for free
+    alignas(64) uint32_t phase[MaxVoices] {};
+    alignas(64) uint32_t phaseInc[MaxVoices] {};
+    alignas(64) float invInc[MaxVoices] {};
+    alignas(64) float monoGain[MaxVoices] {};
+    alignas(64) float stereoGain[MaxChannels][MaxVoices] {};
+
+    // Frequency ratio of each voice to the centre frequency
+    float detuneRatio[MaxVoices] {};
+
+    void updateDetune();
+    void updateIncrements();
+    void updateGains();
+
+    template<unsigned int Lanes, Waveform W>
+    void processLanes(float* const* output, unsigned int numChannels, unsigned int numSamples);
+};
+
+}
@@ -0,0 +1,181 @@
+#include "WavetableOscillator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace DSP
+{
+
+namespace
+{
+
+constexpr unsigned int TableStride { WavetableOscillator::TableSize + 1 };
+constexpr unsigned int FractionBits { 32 - WavetableOscillator::TableBits };
+constexpr uint32_t FractionMask { (1u << FractionBits) - 1u };
+constexpr float FractionScale { 1.f / static_cast<float>(1u << FractionBits) };
+
+// Fourier series amplitude of each harmonic, scaled like the ideal waveform
+double harmonicAmplitude(WavetableOscillator::Waveform waveform, unsigned int harmonic)
+{
+    const double i { static_cast<double>(harmonic) };
+    switch (waveform)
+    {
+        case WavetableOscillator::Sin:
+            return harmonic == 1 ? 1.0 : 0.0;
+
+        case WavetableOscillator::Saw:
+            return 2.0 / (M_PI * i);
+
+        case WavetableOscillator::Square:
+            return (harmonic & 1u) ? 4.0 / (M_PI * i) : 0.0;
+
+        case WavetableOscillator::Tri:
+            if ((harmonic & 1u) == 0)
+                return 0.0;
+            return ((harmonic & 3u) == 1 ? 8.0 : -8.0) / (M_PI * M_PI * i * i);
+
+        default:
+            return 0.0;
+    }
+}
+
+struct Wavetables
+{
+    // Octave tables of each waveform laid out back to back, each with a guard sample
+    // for the interpolation, the sine only needs the first one
+    std::vector<float> data[WavetableOscillator::NumWaveforms];
+
+    Wavetables()
+    {
+        constexpr unsigned int N { WavetableOscillator::TableSize };
+
+        std::vector<double> sinTable(N);
+        for (unsigned int n = 0; n < N; ++n)
+            sinTable[n] = std::sin(2.0 * M_PI * static_cast<double>(n) / static_cast<double>(N));
+
+        std::vector<double> sum(N);
+        for (unsigned int w = 0; w < WavetableOscillator::NumWaveforms; ++w)
+        {
+            const auto waveform { static_cast<WavetableOscillator::Waveform>(w) };
+            const unsigned int numTables { waveform == WavetableOscillator::Sin ? 1u : WavetableOscillator::NumTables };
+            data[w].resize(numTables * TableStride);
+
+            // Start from the table with fewest harmonics and add each octave on top of it,
+            // so every harmonic is summed only once
+            std::fill(sum.begin(), sum.end(), 0.0);
+            unsigned int harmonic { 1 };
+            for (unsigned int t = WavetableOscillator::NumTables; t-- > 0;)
+            {
+                const unsigned int maxHarmonic { WavetableOscillator::MaxHarmonics >> t };
+                for (; harmonic <= maxHarmonic; ++harmonic)
+                {
+                    const double amplitude { harmonicAmplitude(waveform, harmonic) };
+                    if (amplitude == 0.0)
+                        continue;
+
+                    for (unsigned int n = 0; n < N; ++n)
+                        sum[n] += amplitude * sinTable[(harmonic * n) & (N - 1)];
+                }
+
+                if (t < numTables)
+                {
+                    float* table { data[w].data() + t * TableStride };
+                    for (unsigned int n = 0; n < N; ++n)
+                        table[n] = static_cast<float>(sum[n]);
+                    table[N] = table[0];
+                }
+            }
+        }
+    }
+};
+
+const Wavetables& getWavetables()
+{
+    static const Wavetables wavetables;
+    return wavetables;
+}
+
+}
+
+WavetableOscillator::WavetableOscillator(Waveform newWaveform) :
+    waveform { std::min(newWaveform, Tri) }
+{
+    buildTables();
+    updateTable();
+}
+
+WavetableOscillator::~WavetableOscillator()
+{
+}
+
+void WavetableOscillator::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    setFrequency(frequency);
+    reset();
+}
+
+void WavetableOscillator::reset(float startPhase)
+{
+    const double p { static_cast<double>(startPhase) - std::floor(static_cast<double>(startPhase)) };
+    phase = static_cast<uint32_t>(p * 4294967296.0);
+}
+
+void WavetableOscillator::process(float* output, unsigned int numSamples)
+{
+    const float* t { table };
+    uint32_t p { phase };
+    const uint32_t inc { phaseInc };
+
+    for (unsigned int n = 0; n < numSamples; ++n)
+    {
+        const uint32_t index { p >> FractionBits };
+        const float fraction { static_cast<float>(p & FractionMask) * FractionScale };
+        output[n] = t[index] + fraction * (t[index + 1] - t[index]);
+        p += inc;
+    }
+
+    phase = p;
+}
+
+float WavetableOscillator::process()
+{
+    const uint32_t index { phase >> FractionBits };
+    const float fraction { static_cast<float>(phase & FractionMask) * FractionScale };
+    const float output { table[index] + fraction * (table[index + 1] - table[index]) };
+    phase += phaseInc;
+    return output;
+}
+
+void WavetableOscillator::setFrequency(float freqHz)
+{
+    frequency = std::clamp(freqHz, 0.f, static_cast<float>(0.5 * sampleRate));
+    phaseInc = static_cast<uint32_t>(std::round(static_cast<double>(frequency) / sampleRate * 4294967296.0));
+    updateTable();
+}
+
+void WavetableOscillator::setWaveform(Waveform newWaveform)
+{
+    waveform = std::min(newWaveform, Tri);
+    updateTable();
+}
+
+void WavetableOscillator::buildTables()
+{
+    getWavetables();
+}
+
+void WavetableOscillator::updateTable()
+{
+    // Pick the table with the most harmonics that all stay below Nyquist
+    const double inc { static_cast<double>(frequency) / sampleRate };
+    unsigned int t { 0 };
+    if (waveform != Sin)
+        while (t < NumTables - 1 && static_cast<double>(MaxHarmonics >> t) * inc > 0.5)
+            ++t;
+
+    table = getWavetables().data[waveform].data() + t * TableStride;
+}
+
+}
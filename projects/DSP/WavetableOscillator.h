@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+
+namespace DSP
+{
+
+// Band-limited wavetable oscillator
+// Each waveform is stored as octave spaced tables, every one holding only the harmonics
+// that stay below Nyquist for the frequencies it is used for.
+// Tables are built once per process and shared read-only by all oscillators.
+class WavetableOscillator
+{
+public:
+    enum Waveform : unsigned int
+    {
+        Sin = 0,
+        Saw,
+        Square,
+        Tri,
+        NumWaveforms
+    };
+
+    WavetableOscillator(Waveform waveform = Sin);
+    ~WavetableOscillator();
+
+    // No copy semantics
+    WavetableOscillator(const WavetableOscillator&) = delete;
+    const WavetableOscillator& operator=(const WavetableOscillator&) = delete;
+
+    // No move semantics
+    WavetableOscillator(WavetableOscillator&&) = delete;
+    const WavetableOscillator& operator=(WavetableOscillator&&) = delete;
+
+    // Update sample rate and reset phase
+    void prepare(double sampleRate);
+
+    // Reset phase, in cycles
+    void reset(float startPhase = 0.f);
+
+    // Process oscillator output for a buffer
+    void process(float* output, unsigned int numSamples);
+
+    // Process a single sample of the oscillator
+    float process();
+
+    // Set a new frequency for the oscillator in Hz
+    void setFrequency(float freqHz);
+
+    // Select the waveform, the phase is kept
+    void setWaveform(Waveform waveform);
+
+    // Build the shared tables if not built yet, oscillators call it on construction
+    static void buildTables();
+
+    // Samples per table, a power of 2 so the phase accumulator indexes it directly
+    static constexpr unsigned int TableBits { 12 };
+    static constexpr unsigned int TableSize { 1u << TableBits };
+
+    // One table per octave, from MaxHarmonics down to the fundamental only
+    static constexpr unsigned int NumTables { 11 };
+    static constexpr unsigned int MaxHarmonics { 1u << (NumTables - 1) };
+
+private:
+    double sampleRate { 48000.0 };
+    float frequency { 440.f };
+    Waveform waveform { Sin };
+
+    // Phase in cycles as 32 bit fixed point, wraps around for free
+    // The upper bits are the table index, the lower bits the interpolation fraction
+    uint32_t phase { 0 };
+    uint32_t phaseInc { 0 };
+
+    const float* table { nullptr };
+
+    void updateTable();
+};
+
+}
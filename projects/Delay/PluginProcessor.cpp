@@ -16,7 +16,8 @@ static const std::vector<mrta::ParameterInfo> Parameters
 
 DelayAudioProcessor::DelayAudioProcessor() :
     parameterManager(*this, ProjectInfo::projectName, Parameters),
-    delay(Param::Ranges::TimeMax, 2),
+    delayArena(DSP::Delay::getRequiredBytes(MaxSampleRate, Param::Ranges::TimeMax)),
+    delay(delayArena, Param::Ranges::TimeMax, 2),
     wetRamp(0.05f),
     dryRamp(0.05f)
 {
@@ -77,6 +78,8 @@ void DelayAudioProcessor::prepareToPlay(double newSampleRate, int samplesPerBloc
 {
     const unsigned int numChannels { static_cast<unsigned int>(std::max(getMainBusNumInputChannels(), getMainBusNumOutputChannels())) };
 
+    // Re-slice the delay buffers from the preallocated arena
+    delayArena.reset();
     delay.prepare(newSampleRate, Param::Ranges::TimeMax, numChannels);
     wetRamp.prepare(newSampleRate);
     dryRamp.prepare(newSampleRate);
@@ -106,9 +106,11 @@ public:
     static const unsigned int MaxDelaySizeSamples { 1 << 12 };
     static const unsigned int MaxChannels { 2 };
     static const unsigned int MaxProcessBlockSamples{ 32 };
+    static constexpr double MaxSampleRate { 192000.0 };
 
 private:
     mrta::ParameterManager parameterManager;
+    DSP::MemoryArena delayArena;
     DSP::Delay delay;
     DSP::Ramp<float> wetRamp;
     DSP::Ramp<float> dryRamp;
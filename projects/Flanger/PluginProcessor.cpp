@@ -14,7 +14,8 @@ static const std::vector<mrta::ParameterInfo> Parameters
 
 FlangerAudioProcessor::FlangerAudioProcessor() :
     parameterManager(*this, ProjectInfo::projectName, Parameters),
-    flanger(MaxDelaySizeMs, 2),
+    delayArena(DSP::Flanger::getRequiredBytes(MaxSampleRate, MaxDelaySizeMs)),
+    flanger(delayArena, MaxDelaySizeMs, 2),
     enableRamp(0.05f)
 {
     parameterManager.registerParameterCallback(Param::ID::Enabled,
@@ -58,6 +59,8 @@ void FlangerAudioProcessor::prepareToPlay(double newSampleRate, int samplesPerBl
 {
     const unsigned int numChannels { static_cast<unsigned int>(std::max(getMainBusNumInputChannels(), getMainBusNumOutputChannels())) };
 
+    // Re-slice the delay buffers from the preallocated arena
+    delayArena.reset();
     flanger.prepare(newSampleRate, MaxDelaySizeMs, numChannels);
     enableRamp.prepare(newSampleRate, true, enabled ? 1.f : 0.f);
 
@@ -86,9 +86,11 @@ public:
     static constexpr float MaxDelaySizeMs { 20.f };
     static const unsigned int MaxChannels { 2 };
     static const unsigned int MaxProcessBlockSamples{ 32 };
+    static constexpr double MaxSampleRate { 192000.0 };
 
 private:
     mrta::ParameterManager parameterManager;
+    DSP::MemoryArena delayArena;
     DSP::Flanger flanger;
     DSP::Ramp<float> enableRamp;
 
@@ -27,7 +27,8 @@ namespace Param
         static constexpr float AttRelTimeInc { 0.1f };
         static constexpr float AttRelTimeSkw { 0.5f };
 
-        static const juce::StringArray WaveType { "Sine", "Tri. Aliased", "Saw Aliased", "Tri. AA", "Saw AA" };
+        static const juce::StringArray WaveType { "Sine", "Tri. Aliased", "Saw Aliased", "Tri. AA", "Saw AA",
+                                                  "Saw BLEP", "Square BLEP", "Pulse BLEP", "Tri. BLAMP" };
     }
 }
 
@@ -1,59 +1,141 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
+#include <algorithm>
+#include <cmath>
 
-void ModulatedDelay::prepare(double sampleRate, int maxDelayMilliseconds)
+ModulatedDelay::ModulatedDelay() :
+    delayLine(getDelayLineLength(48000.0, 2000.0f), MaxChannels),
+    depthRamp(0.05f),
+    feedbackRamp(0.05f),
+    wetRamp(0.05f),
+    dryRamp(0.05f)
+{
+}
+
+ModulatedDelay::ModulatedDelay(DSP::MemoryArena& arena) :
+    delayLine(arena, getDelayLineLength(48000.0, 2000.0f), MaxChannels),
+    depthRamp(0.05f),
+    feedbackRamp(0.05f),
+    wetRamp(0.05f),
+    dryRamp(0.05f)
+{
+}
+
+size_t ModulatedDelay::getRequiredBytes(double maxSampleRate, float maxDelayMs)
+{
+    return DSP::DelayLine::getRequiredBytes(getDelayLineLength(maxSampleRate, maxDelayMs), MaxChannels);
+}
+
+unsigned int ModulatedDelay::getDelayLineLength(double sampleRate, float maxDelayMs)
+{
+    return static_cast<unsigned int>(std::ceil((maxDelayMs + MaxDepthMs) * 0.001 * sampleRate)) + 2;
+}
+
+void ModulatedDelay::prepare(double sampleRate, float maxDelayMs, unsigned int newNumChannels)
 {
     sr = sampleRate;
-    size_t maxDelaySamples = size_t((maxDelayMilliseconds / 1000.0) * sr) + 1;
-    buffer.setSize (1, (int)maxDelaySamples);
-    buffer.clear();
-    writeIndex = 0;
+    numChannels = newNumChannels;
+
+    delayLine.prepare(getDelayLineLength(sr, maxDelayMs), numChannels);
+    delayLine.setSmoothingTime(0.05f, sr);
+    delayLine.setDelay(delayMs * static_cast<float>(0.001 * sr), true);
+
+    lfo.setFrequency(rateHz);
+    lfo.prepare(sr);
 
-    delayTimeSmooth  = targetDelayMs;
-    feedbackSmooth   = targetFeedback;
-    wetDrySmooth     = targetWetDry;     
+    depthRamp.prepare(sr, true, depthMs * static_cast<float>(0.001 * sr));
+    feedbackRamp.prepare(sr, true, feedback);
+    wetRamp.prepare(sr, true, wetDry);
+    dryRamp.prepare(sr, true, 1.0f - wetDry);
+
+    const auto minDelaySamples = static_cast<unsigned int>(MinDelayMs * 0.001 * sr);
+    subBlockSize = std::clamp(minDelaySamples, 1u, SubBlockSize);
+
+    modBuffer.assign(numChannels * SubBlockSize, 0.0f);
+    delayedBuffer.assign(numChannels * SubBlockSize, 0.0f);
+    writeBuffer.assign(numChannels * SubBlockSize, 0.0f);
+    modPointers.resize(numChannels);
+    delayedPointers.resize(numChannels);
+    writePointers.resize(numChannels);
+    ioPointers.resize(numChannels);
+    for (unsigned int ch = 0; ch < numChannels; ++ch)
+    {
+        modPointers[ch] = modBuffer.data() + ch * SubBlockSize;
+        delayedPointers[ch] = delayedBuffer.data() + ch * SubBlockSize;
+        writePointers[ch] = writeBuffer.data() + ch * SubBlockSize;
+    }
 }
 
-void ModulatedDelay::setParameters(float newDelayMs, float newFeedback, float newWet)
+void ModulatedDelay::setParameters(float newDelayMs, float newFeedback, float newWet, float newRateHz, float newDepthMs)
 {
-    targetDelayMs = newDelayMs;
-    targetFeedback = newFeedback;
-    targetWetDry = newWet;
+    // Only restart the delay time glide on actual changes
+    newDelayMs = std::max(newDelayMs, MinDelayMs);
+    if (newDelayMs != delayMs)
+    {
+        delayMs = newDelayMs;
+        delayLine.setDelay(delayMs * static_cast<float>(0.001 * sr));
+    }
+
+    if (newRateHz != rateHz)
+    {
+        rateHz = newRateHz;
+        lfo.setFrequency(rateHz);
+    }
+
+    feedback = newFeedback;
+    wetDry = newWet;
+    depthMs = std::clamp(newDepthMs, 0.0f, MaxDepthMs);
+
+    depthRamp.setTarget(depthMs * static_cast<float>(0.001 * sr));
+    feedbackRamp.setTarget(feedback);
+    wetRamp.setTarget(wetDry);
+    dryRamp.setTarget(1.0f - wetDry);
 }
 
-void ModulatedDelay::processBlock(AudioBuffer<float>& bufferToFill)
+void ModulatedDelay::processBlock(juce::AudioBuffer<float>& bufferToFill)
 {
-    auto* buf = buffer.getWritePointer(0);
-    auto* in  = bufferToFill.getReadPointer (0);
-    auto* out = bufferToFill.getWritePointer (0);
-    int numSamples = bufferToFill.getNumSamples();
-        
-    for (int n = 0; n < numSamples; ++n)
+    const auto channels = std::min(static_cast<unsigned int>(bufferToFill.getNumChannels()), numChannels);
+    const auto numSamples = static_cast<unsigned int>(bufferToFill.getNumSamples());
+    const auto lfoChannels = std::min(channels, DSP::LFO::MaxChannels);
+
+    for (unsigned int offset = 0; offset < numSamples; offset += subBlockSize)
     {
-        delayTimeSmooth  += smoothingCoeff * (targetDelayMs  - delayTimeSmooth);
-        feedbackSmooth   += smoothingCoeff * (targetFeedback - feedbackSmooth);
-        wetDrySmooth     += smoothingCoeff * (targetWetDry   - wetDrySmooth);
-        float dryGain = 1.0f - wetDrySmooth;
-            
-        float delaySamples = (delayTimeSmooth / 1000.0f) * float(sr);
-        
-        int readIndex = writeIndex - int(delaySamples);
-        if (readIndex < 0) 
-            readIndex += buffer.getNumSamples();
-        
-        float delayedIn  = buf[readIndex];
-        float delayedOut = buf[readIndex]; 
-    
-        float xn = in[n];
-        float yn = wetDrySmooth * (delayedIn + feedbackSmooth * delayedOut)
-                   + dryGain * xn;
-        
-        buf[writeIndex] = yn;
-        out[n] = yn;
-    
-        if (++writeIndex >= buffer.getNumSamples())
-            writeIndex = 0;
+        const unsigned int blockSize = std::min(subBlockSize, numSamples - offset);
+
+        for (unsigned int ch = 0; ch < channels; ++ch)
+            ioPointers[ch] = bufferToFill.getWritePointer(static_cast<int>(ch), static_cast<int>(offset));
+
+        // Unipolar delay time modulation in samples, quadrature between L and R
+        // Any further channels reuse the L/R modulation alternately,
+        // mapped from the last channel down so L/R are still bipolar when copied
+        lfo.process(modPointers.data(), lfoChannels, blockSize);
+        for (unsigned int ch = channels; ch-- > 0;)
+        {
+            const float* lfoOut = modPointers[ch % DSP::LFO::MaxChannels];
+            for (unsigned int n = 0; n < blockSize; ++n)
+                modPointers[ch][n] = 0.5f + 0.5f * lfoOut[n];
+        }
+        depthRamp.applyGain(modPointers.data(), channels, blockSize);
+
+        // The delayed signal only depends on samples written by previous sub-blocks
+        delayLine.read(delayedPointers.data(), modPointers.data(), channels, blockSize);
+
+        // Delay input is the dry input plus feedback
+        for (unsigned int ch = 0; ch < channels; ++ch)
+            std::copy(delayedPointers[ch], delayedPointers[ch] + blockSize, writePointers[ch]);
+        feedbackRamp.applyGain(writePointers.data(), channels, blockSize);
+        for (unsigned int ch = 0; ch < channels; ++ch)
+            for (unsigned int n = 0; n < blockSize; ++n)
+                writePointers[ch][n] += ioPointers[ch][n];
+        delayLine.write(writePointers.data(), channels, blockSize);
+
+        // Wet/dry mix
+        wetRamp.applyGain(delayedPointers.data(), channels, blockSize);
+        dryRamp.applyGain(ioPointers.data(), channels, blockSize);
+        for (unsigned int ch = 0; ch < channels; ++ch)
+            for (unsigned int n = 0; n < blockSize; ++n)
+                ioPointers[ch][n] += delayedPointers[ch][n];
     }
 }
 
@@ -64,11 +146,14 @@ static const std::vector<mrta::ParameterInfo> ParameterInfos
     { Param::ID::DelayTime, "Delay Time",  "ms",  500.0f,     1.0f,    2000.0f,   1.0f,   1.0f },
     { Param::ID::Feedback,  "Feedback",     "",    0.5f,       0.0f,    0.99f,     0.01f,  1.0f },
     { Param::ID::WetDryMix, "Wet/Dry Mix",  "",    0.5f,       0.0f,    1.0f,      0.01f,  1.0f },
+    { Param::ID::Rate,      "Rate",         "Hz",  0.5f,       0.01f,   10.0f,     0.01f,  0.5f },
+    { Param::ID::Depth,     "Depth",        "ms",  2.0f,       0.0f,    10.0f,     0.01f,  1.0f },
 };
 
 MainProcessor::MainProcessor() :
     parameterManager(*this, ProjectInfo::projectName, ParameterInfos),
-    modulatedDelay()
+    delayArena(ModulatedDelay::getRequiredBytes(MaxSampleRate, MaxDelayMs)),
+    modulatedDelay(delayArena)
 {
     parameterManager.registerParameterCallback(Param::ID::Enabled,
         [this](float value, bool)
@@ -93,6 +178,18 @@ MainProcessor::MainProcessor() :
         {
             wetDry = value;
         });
+
+    parameterManager.registerParameterCallback(Param::ID::Rate,
+        [this](float value, bool)
+        {
+            rate = value;
+        });
+
+    parameterManager.registerParameterCallback(Param::ID::Depth,
+        [this](float value, bool)
+        {
+            depth = value;
+        });
 }
 
 MainProcessor::~MainProcessor()
@@ -104,7 +201,11 @@ void MainProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
     juce::uint32 numChannels { static_cast<juce::uint32>(std::max(getMainBusNumInputChannels(), getMainBusNumOutputChannels())) };
     parameterManager.updateParameters(true);
 
-    modulatedDelay.prepare(sampleRate, 2000);
+    modulatedDelay.setParameters(delayTime, feedback, wetDry, rate, depth);
+
+    // Re-slice the delay buffers from the preallocated arena
+    delayArena.reset();
+    modulatedDelay.prepare(sampleRate, MaxDelayMs, numChannels);
 }
 
 void MainProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& /*midiMessages*/)
@@ -113,7 +214,7 @@ void MainProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuf
     parameterManager.updateParameters();
     if (!enabled) return;
 
-    modulatedDelay.setParameters(delayTime, feedback, wetDry);
+    modulatedDelay.setParameters(delayTime, feedback, wetDry, rate, depth);
     modulatedDelay.processBlock(buffer);
 }
 
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "DelayLine.h"
+#include "LFO.h"
+#include "Ramp.h"
 
 namespace Param
 {
@@ -10,6 +13,8 @@ namespace Param
         static const juce::String DelayTime  { "delayTime" };
         static const juce::String Feedback   { "feedback"  };
         static const juce::String WetDryMix  { "wetDry"    };
+        static const juce::String Rate       { "rate"      };
+        static const juce::String Depth      { "depth"     };
     }
 
     namespace Name
@@ -18,33 +23,64 @@ namespace Param
         static const juce::String DelayTime  { "Delay Time (ms)" };
         static const juce::String Feedback   { "Feedback"         };
         static const juce::String WetDryMix  { "Wet/Dry Mix"      };
+        static const juce::String Rate       { "Rate"             };
+        static const juce::String Depth      { "Depth"            };
     }
 }
 
 class ModulatedDelay
 {
 public:
-    ModulatedDelay() = default;
+    ModulatedDelay();
+
+    // Arena backed ctor, the delay buffer is sliced from the shared arena
+    ModulatedDelay(DSP::MemoryArena& arena);
     ~ModulatedDelay() = default;
 
-    void prepare(double sampleRate, int samplesPerBlock);
-    void setParameters(float newDelayMs, float newFeedback, float newWet);
+    void prepare(double sampleRate, float maxDelayMs, unsigned int numChannels);
+
+    // Arena space needed when preparing up to maxSampleRate
+    static size_t getRequiredBytes(double maxSampleRate, float maxDelayMs);
+    void setParameters(float newDelayMs, float newFeedback, float newWet, float newRateHz, float newDepthMs);
     void processBlock(juce::AudioBuffer<float>& buffer);
 
+    static constexpr float MinDelayMs = 1.0f;
+    static constexpr float MaxDepthMs = 10.0f;
+    static constexpr unsigned int MaxChannels = 2;
+
 private:
-    juce::AudioBuffer<float> buffer;
+    // Room for the longest delay time plus the full modulation depth
+    static unsigned int getDelayLineLength(double sampleRate, float maxDelayMs);
+
+    DSP::DelayLine delayLine;
+    DSP::LFO lfo;
+
+    DSP::Ramp<float> depthRamp;
+    DSP::Ramp<float> feedbackRamp;
+    DSP::Ramp<float> wetRamp;
+    DSP::Ramp<float> dryRamp;
+
     double sr = 48000.0;
-    int writeIndex = 0;
+    unsigned int numChannels = 0;
 
-    float targetDelayMs   = 500.0f;
-    float targetFeedback  = 0.5f;
-    float targetWetDry    = 0.5f;
+    float delayMs   = 500.0f;
+    float feedback  = 0.5f;
+    float wetDry    = 0.5f;
+    float rateHz    = 0.5f;
+    float depthMs   = 2.0f;
 
-    float delayTimeSmooth = 500.0f;
-    float feedbackSmooth  = 0.5f;
-    float wetDrySmooth    = 0.5f;
-    
-    const float smoothingCoeff = 0.001f;
+    // Feedback is computed in sub-blocks no longer than the minimum delay time
+    static constexpr unsigned int SubBlockSize = 64;
+    unsigned int subBlockSize = SubBlockSize;
+
+    // Scratch buffers, one sub-block per channel
+    std::vector<float> modBuffer;
+    std::vector<float> delayedBuffer;
+    std::vector<float> writeBuffer;
+    std::vector<float*> modPointers;
+    std::vector<float*> delayedPointers;
+    std::vector<float*> writePointers;
+    std::vector<float*> ioPointers;
 };
 
 class MainProcessor : public juce::AudioProcessor
@@ -62,6 +98,9 @@ public:
 
     mrta::ParameterManager& getParameterManager() { return parameterManager; }
 
+    static constexpr float MaxDelayMs = 2000.0f;
+    static constexpr double MaxSampleRate = 192000.0;
+
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
@@ -79,11 +118,14 @@ public:
 
 private:
     mrta::ParameterManager parameterManager;
+    DSP::MemoryArena delayArena;
     ModulatedDelay modulatedDelay;
-    bool enabled;
+    bool enabled = true;
     float delayTime = 500.0f;
     float feedback  = 0.5f;
     float wetDry    = 0.5f;
+    float rate      = 0.5f;
+    float depth     = 2.0f;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MainProcessor)
 };
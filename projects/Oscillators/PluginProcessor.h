@@ -11,6 +11,7 @@ namespace Param
     {
         static const juce::String OscRate { "osc_rate" };
         static const juce::String OscType { "osc_type" };
+        static const juce::String PulseWidth { "pulse_width" };
         static const juce::String Volume { "volume" };
     }
 
@@ -18,6 +19,7 @@ namespace Param
     {
         static const juce::String OscRate { "Osc. Rate" };
         static const juce::String OscType { "Osc. Type" };
+        static const juce::String PulseWidth { "Pulse Width" };
         static const juce::String Volume { "Volume" };
     }
 
@@ -25,6 +27,7 @@ namespace Param
     {
         static const juce::String Hz { "Hz" };
         static const juce::String dB { "dB" };
+        static const juce::String Percent { "%" };
     }
 
     namespace Range
@@ -34,12 +37,18 @@ namespace Param
         static constexpr float OscRateInc { 0.1f };
         static constexpr float OscRateSkw { 0.5f };
 
+        static constexpr float PulseWidthMin { 1.f };
+        static constexpr float PulseWidthMax { 99.f };
+        static constexpr float PulseWidthInc { 0.1f };
+        static constexpr float PulseWidthSkw { 1.f };
+
         static constexpr float VolumeMin { -60.f };
         static constexpr float VolumeMax { 12.f };
         static constexpr float VolumeInc { 0.1f };
         static constexpr float VolumeSkw { 3.8018f };
 
-        static const juce::StringArray OscTypeLabels { "Sine", "Triangle Aliased", "Saw Aliased", "Triangle AA", "Saw AA" };
+        static const juce::StringArray OscTypeLabels { "Sine", "Triangle Aliased", "Saw Aliased", "Triangle AA", "Saw AA",
+                                                       "Saw BLEP", "Square BLEP", "Pulse BLEP", "Triangle BLAMP" };
     }
 }
 
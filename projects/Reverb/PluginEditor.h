@@ -0,0 +1,26 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "MeterComponent.h"
+#include "MrtaLAF.h"
+
+class ReverbAudioProcessorEditor  : public juce::AudioProcessorEditor
+{
+public:
+    ReverbAudioProcessorEditor(ReverbAudioProcessor&);
+    ~ReverbAudioProcessorEditor() override;
+
+    static constexpr int METER_WIDTH { 40 };
+
+    void paint(juce::Graphics&) override;
+    void resized() override;
+
+private:
+    ReverbAudioProcessor& audioProcessor;
+    mrta::GenericParameterEditor genericParameterEditor;
+    GUI::MeterComponent meterComponent;
+    GUI::MrtaLAF laf;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ReverbAudioProcessorEditor)
+};
\ No newline at end of file
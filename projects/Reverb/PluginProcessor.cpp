@@ -0,0 +1,134 @@
+#include "PluginProcessor.h"
+#include "PluginEditor.h"
+
+#include <algorithm>
+
+static const std::vector<mrta::ParameterInfo> Parameters
+{
+    { Param::ID::Enabled, Param::Name::Enabled, Param::Ranges::EnabledOff, Param::Ranges::EnabledOn, true },
+    { Param::ID::Mix,     Param::Name::Mix,     "",                0.3f,    Param::Ranges::MixMin,     Param::Ranges::MixMax,     Param::Ranges::MixInc,     Param::Ranges::MixSkw },
+    { Param::ID::Decay,   Param::Name::Decay,   Param::Units::Sec, 2.f,     Param::Ranges::DecayMin,   Param::Ranges::DecayMax,   Param::Ranges::DecayInc,   Param::Ranges::DecaySkw },
+    { Param::ID::Size,    Param::Name::Size,    "",                0.5f,    Param::Ranges::SizeMin,    Param::Ranges::SizeMax,    Param::Ranges::SizeInc,    Param::Ranges::SizeSkw },
+    { Param::ID::Damping, Param::Name::Damping, Param::Units::Hz,  4000.f,  Param::Ranges::DampingMin, Param::Ranges::DampingMax, Param::Ranges::DampingInc, Param::Ranges::DampingSkw }
+};
+
+ReverbAudioProcessor::ReverbAudioProcessor() :
+    parameterManager(*this, ProjectInfo::projectName, Parameters),
+    delayArena(DSP::FDNReverb::getRequiredBytes(MaxSampleRate, NumLines)),
+    reverb(delayArena, NumLines),
+    wetRamp(0.05f),
+    dryRamp(0.05f)
+{
+    meter.setTimeConstant(150.f);
+
+    parameterManager.registerParameterCallback(Param::ID::Enabled,
+    [this](float newValue, bool force)
+    {
+        enabled = newValue;
+        wetRamp.setTarget(std::clamp(enabled * mix, 0.f, 1.f), force);
+        dryRamp.setTarget(std::clamp((1.f - mix) * enabled + (1.f - enabled), 0.f, 1.f), force);
+    });
+
+    parameterManager.registerParameterCallback(Param::ID::Mix,
+    [this] (float value, bool force)
+    {
+        mix = value;
+        wetRamp.setTarget(std::clamp(enabled * mix, 0.f, 1.f), force);
+        dryRamp.setTarget(std::clamp((1.f - mix) * enabled + (1.f - enabled), 0.f, 1.f), force);
+    });
+
+    parameterManager.registerParameterCallback(Param::ID::Decay,
+    [this] (float value, bool /*force*/)
+    {
+        decay = value;
+        reverb.setDecayTime(value);
+    });
+
+    parameterManager.registerParameterCallback(Param::ID::Size,
+    [this] (float value, bool /*force*/)
+    {
+        reverb.setSize(value);
+    });
+
+    parameterManager.registerParameterCallback(Param::ID::Damping,
+    [this] (float value, bool /*force*/)
+    {
+        reverb.setDampingFrequency(value);
+    });
+}
+
+ReverbAudioProcessor::~ReverbAudioProcessor()
+{
+}
+
+void ReverbAudioProcessor::prepareToPlay(double newSampleRate, int samplesPerBlock)
+{
+    const unsigned int numChannels { static_cast<unsigned int>(std::max(getMainBusNumInputChannels(), getMainBusNumOutputChannels())) };
+
+    // Re-slice the delay buffers from the preallocated arena
+    delayArena.reset();
+    reverb.prepare(newSampleRate);
+    wetRamp.prepare(newSampleRate);
+    dryRamp.prepare(newSampleRate);
+    meter.prepare(newSampleRate, numChannels);
+
+    parameterManager.updateParameters(true);
+
+    fxBuffer.setSize(static_cast<int>(numChannels), samplesPerBlock);
+    fxBuffer.clear();
+}
+
+void ReverbAudioProcessor::releaseResources()
+{
+    reverb.clear();
+}
+
+void ReverbAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& /*midiMessages*/)
+{
+    juce::ScopedNoDenormals noDenormals;
+    parameterManager.updateParameters();
+
+    const unsigned int numChannels { static_cast<unsigned int>(buffer.getNumChannels()) };
+    const unsigned int numSamples { static_cast<unsigned int>(buffer.getNumSamples()) };
+
+    reverb.process(fxBuffer.getArrayOfWritePointers(), buffer.getArrayOfReadPointers(), numChannels, numSamples);
+    meter.process(fxBuffer.getArrayOfReadPointers(), numChannels, numSamples);
+
+    wetRamp.applyGain(fxBuffer.getArrayOfWritePointers(), numChannels, numSamples);
+    dryRamp.applyGain(buffer.getArrayOfWritePointers(), numChannels, numSamples);
+
+    for (int ch = 0; ch < static_cast<int>(numChannels); ++ch)
+        buffer.addFrom(ch, 0, fxBuffer, ch, 0, static_cast<int>(numSamples));
+}
+
+void ReverbAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
+{
+    parameterManager.getStateInformation(destData);
+}
+
+void ReverbAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
+{
+    parameterManager.setStateInformation(data, sizeInBytes);
+}
+
+//==============================================================================
+bool ReverbAudioProcessor::hasEditor() const { return true; }
+juce::AudioProcessorEditor* ReverbAudioProcessor::createEditor() { return new ReverbAudioProcessorEditor(*this); }
+const juce::String ReverbAudioProcessor::getName() const { return JucePlugin_Name; }
+bool ReverbAudioProcessor::acceptsMidi() const { return false; }
+bool ReverbAudioProcessor::producesMidi() const { return false; }
+bool ReverbAudioProcessor::isMidiEffect() const { return false; }
+double ReverbAudioProcessor::getTailLengthSeconds() const { return static_cast<double>(decay); }
+int ReverbAudioProcessor::getNumPrograms() { return 1; }
+int ReverbAudioProcessor::getCurrentProgram() { return 0; }
+void ReverbAudioProcessor::setCurrentProgram(int) { }
+const juce::String ReverbAudioProcessor::getProgramName (int) { return {}; }
+void ReverbAudioProcessor::changeProgramName (int, const juce::String&) { }
+//==============================================================================
+
+//==============================================================================
+// This creates new instances of the plugin..
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+    return new ReverbAudioProcessor();
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "FDNReverb.h"
+#include "Meter.h"
+#include "Ramp.h"
+
+namespace Param
+{
+    namespace ID
+    {
+        static const juce::String Enabled { "enabled" };
+        static const juce::String Mix { "mix" };
+        static const juce::String Decay { "decay" };
+        static const juce::String Size { "size" };
+        static const juce::String Damping { "damping" };
+    }
+
+    namespace Name
+    {
+        static const juce::String Enabled { "Enabled" };
+        static const juce::String Mix { "Mix" };
+        static const juce::String Decay { "Decay" };
+        static const juce::String Size { "Size" };
+        static const juce::String Damping { "Damping" };
+    }
+
+    namespace Ranges
+    {
+        static constexpr float MixMin { 0.f };
+        static constexpr float MixMax { 1.f };
+        static constexpr float MixInc { 0.001f };
+        static constexpr float MixSkw { 1.0f };
+
+        static constexpr float DecayMin { 0.1f };
+        static constexpr float DecayMax { 30.f };
+        static constexpr float DecayInc { 0.01f };
+        static constexpr float DecaySkw { 0.3f };
+
+        static constexpr float SizeMin { 0.f };
+        static constexpr float SizeMax { 1.f };
+        static constexpr float SizeInc { 0.001f };
+        static constexpr float SizeSkw { 1.0f };
+
+        static constexpr float DampingMin { 200.f };
+        static constexpr float DampingMax { 20000.f };
+        static constexpr float DampingInc { 1.f };
+        static constexpr float DampingSkw { 0.4f };
+
+        static const juce::String EnabledOff { "Off" };
+        static const juce::String EnabledOn { "On" };
+    }
+
+    namespace Units
+    {
+        static const juce::String Sec { "s" };
+        static const juce::String Hz { "Hz" };
+    }
+}
+
+class ReverbAudioProcessor : public juce::AudioProcessor
+{
+public:
+    ReverbAudioProcessor();
+    ~ReverbAudioProcessor() override;
+
+    void prepareToPlay(double sampleRate, int samplesPerBlock) override;
+    void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void releaseResources() override;
+
+    void getStateInformation (juce::MemoryBlock& destData) override;
+    void setStateInformation (const void* data, int sizeInBytes) override;
+
+    mrta::ParameterManager& getParameterManager() { return parameterManager; }
+    DSP::Meter& getMeter() { return meter; }
+
+    //==============================================================================
+    juce::AudioProcessorEditor* createEditor() override;
+    bool hasEditor() const override;
+    const juce::String getName() const override;
+    bool acceptsMidi() const override;
+    bool producesMidi() const override;
+    bool isMidiEffect() const override;
+    double getTailLengthSeconds() const override;
+    int getNumPrograms() override;
+    int getCurrentProgram() override;
+    void setCurrentProgram (int index) override;
+    const juce::String getProgramName (int index) override;
+    void changeProgramName (int index, const juce::String& newName) override;
+    //==============================================================================
+
+    static const unsigned int NumLines { 16 };
+    static constexpr double MaxSampleRate { 192000.0 };
+
+private:
+    mrta::ParameterManager parameterManager;
+    DSP::MemoryArena delayArena;
+    DSP::FDNReverb reverb;
+    DSP::Ramp<float> wetRamp;
+    DSP::Ramp<float> dryRamp;
+    DSP::Meter meter;
+
+    float enabled { 1.f };
+    float mix { 0.3f };
+    float decay { 2.f };
+
+    juce::AudioBuffer<float> fxBuffer;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ReverbAudioProcessor)
+};
@@ -21,22 +21,23 @@ static const std::vector<mrta::ParameterInfo> parameters
 };
 
 StateVariableFilterAudioProcessor::StateVariableFilterAudioProcessor() :
-    parameterManager(*this, ProjectInfo::projectName, parameters),
-    freqRamp(0.005f),
-    freqModAmtRamp(0.005f)
+    parameterManager(*this, ProjectInfo::projectName, parameters)
 {
+    controls.setRampTime(FreqControl, 0.005f);
+    controls.setRampTime(FreqModAmtControl, 0.005f);
+
     parameterManager.registerParameterCallback(Param::ID::Freq,
     [this] (float value, bool force)
     {
         freqHz = value;
-        freqRamp.setTarget(value, force);
+        controls.setTarget(FreqControl, value, force);
     });
 
     parameterManager.registerParameterCallback(Param::ID::FreqModAmt,
     [this] (float value, bool force)
     {
         freqModAmt = std::clamp(value, 0.f, 1.f);
-        freqModAmtRamp.setTarget(freqModAmt, force);
+        controls.setTarget(FreqModAmtControl, freqModAmt, force);
     });
 
     parameterManager.registerParameterCallback(Param::ID::FreqModRate,
@@ -49,7 +50,7 @@ StateVariableFilterAudioProcessor::StateVariableFilterAudioProcessor() :
     [this] (float value, bool force)
     {
         reso = value;
-        resoRamp.setTarget(value, force);
+        controls.setTarget(ResoControl, value, force);
     });
 
     parameterManager.registerParameterCallback(Param::ID::Mode,
@@ -58,9 +59,9 @@ StateVariableFilterAudioProcessor::StateVariableFilterAudioProcessor() :
         mode = value;
         float lpf(0.f), bpf(0.f), hpf(0.f);
         modeMix(mode, lpf, bpf, hpf);
-        lpfRamp.setTarget(lpf, force);
-        bpfRamp.setTarget(bpf, force);
-        hpfRamp.setTarget(hpf, force);
+        controls.setTarget(LPFControl, lpf, force);
+        controls.setTarget(BPFControl, bpf, force);
+        controls.setTarget(HPFControl, hpf, force);
     });
 
     lfo.setType(DSP::Oscillator::Sin);
@@ -74,23 +75,15 @@ void StateVariableFilterAudioProcessor::prepareToPlay(double sampleRate, int sam
 {
     parameterManager.updateParameters(true);
 
-    svfLeft.prepare(sampleRate);
-    svfRight.prepare(sampleRate);
+    svf.prepare(sampleRate);
     lfo.prepare(sampleRate);
 
-    freqRamp.prepare(sampleRate, true, freqHz);
-    freqModAmtRamp.prepare(sampleRate, true, freqModAmt);
-    resoRamp.prepare(sampleRate, true, reso);
-
-    float lpf, bpf, hpf;
-    modeMix(mode, lpf, bpf, hpf);
-    lpfRamp.prepare(sampleRate, true, lpf);
-    bpfRamp.prepare(sampleRate, true, bpf);
-    hpfRamp.prepare(sampleRate, true, hpf);
+    // skip all controls to the current parameter values
+    controls.prepare(sampleRate, true);
 
     // resize the aux buffers
+    controlBuffer.setSize(1, samplesPerBlock * NumControls);
     freqInBuffer.setSize(1, samplesPerBlock);
-    freqModAmtBuffer.setSize(1, samplesPerBlock);
     lfoBuffer.setSize(1, samplesPerBlock);
     resoInBuffer.setSize(1, samplesPerBlock);
     lpfOutBuffer.setSize(2, samplesPerBlock);
@@ -111,60 +104,51 @@ void StateVariableFilterAudioProcessor::processBlock(juce::AudioBuffer<float>& b
     const unsigned int numSamples{ static_cast<unsigned int>(buffer.getNumSamples()) };
 
     // clear all aux buffers
-    freqInBuffer.clear();
-    freqModAmtBuffer.clear();
     lfoBuffer.clear();
-    resoInBuffer.clear();
     lpfOutBuffer.clear();
     bpfOutBuffer.clear();
     hpfOutBuffer.clear();
 
-    // get the freq and reso controls
-    freqRamp.applySum(freqInBuffer.getWritePointer(0), numSamples);
-    resoRamp.applySum(resoInBuffer.getWritePointer(0), numSamples);
-    freqModAmtRamp.applySum(freqModAmtBuffer.getWritePointer(0), numSamples);
+    // get all smoothed controls, one control vector per sample
+    controls.process(controlBuffer.getWritePointer(0), numSamples);
+    const float* control { controlBuffer.getReadPointer(0) };
 
-    // calculate LFO in Hz
+    // calculate LFO in Hz, and the freq and reso controls
     lfo.process(lfoBuffer.getWritePointer(0), numSamples);
+    const float* lfoIn { lfoBuffer.getReadPointer(0) };
+    float* freqIn { freqInBuffer.getWritePointer(0) };
+    float* resoIn { resoInBuffer.getWritePointer(0) };
     for (unsigned int n = 0; n < numSamples; ++n)
     {
-        const float curFreq = freqInBuffer.getSample(0, n);
-        const float modAmtHz = curFreq * FreqModAmtMax * freqModAmtBuffer.getSample(0, n);
-        const float modFreq = modAmtHz * lfoBuffer.getSample(0, n) + curFreq;
-        freqInBuffer.setSample(0, n, modFreq);
+        const float* c { control + n * NumControls };
+        const float curFreq = c[FreqControl];
+        const float modAmtHz = curFreq * FreqModAmtMax * c[FreqModAmtControl];
+        freqIn[n] = modAmtHz * lfoIn[n] + curFreq;
+        resoIn[n] = c[ResoControl];
     }
 
-    // always process left channel
-    svfLeft.process(lpfOutBuffer.getWritePointer(0),
-                    bpfOutBuffer.getWritePointer(0),
-                    hpfOutBuffer.getWritePointer(0),
-                    buffer.getReadPointer(0),
-                    freqInBuffer.getReadPointer(0),
-                    resoInBuffer.getReadPointer(0),
-                    numSamples);
-
-    // if stereo, also process right channel
-    if (numChannels > 1)
-    {
-        svfRight.process(lpfOutBuffer.getWritePointer(1),
-                         bpfOutBuffer.getWritePointer(1),
-                         hpfOutBuffer.getWritePointer(1),
-                         buffer.getReadPointer(1),
-                         freqInBuffer.getReadPointer(0),
-                         resoInBuffer.getReadPointer(0),
-                         numSamples);
-    }
+    // process all channels in one pass, sharing the filter coefficients
+    svf.process(lpfOutBuffer.getArrayOfWritePointers(),
+                bpfOutBuffer.getArrayOfWritePointers(),
+                hpfOutBuffer.getArrayOfWritePointers(),
+                buffer.getArrayOfReadPointers(),
+                freqInBuffer.getReadPointer(0),
+                resoInBuffer.getReadPointer(0),
+                numChannels,
+                numSamples);
 
     // mix outputs
-    lpfRamp.applyGain(lpfOutBuffer.getArrayOfWritePointers(), numChannels, numSamples);
-    bpfRamp.applyGain(bpfOutBuffer.getArrayOfWritePointers(), numChannels, numSamples);
-    hpfRamp.applyGain(hpfOutBuffer.getArrayOfWritePointers(), numChannels, numSamples);
-    buffer.clear();
-    for (int ch = 0; ch < numChannels; ++ch)
+    for (unsigned int ch = 0; ch < numChannels; ++ch)
     {
-        buffer.addFrom(ch, 0, lpfOutBuffer, ch, 0, numSamples);
-        buffer.addFrom(ch, 0, bpfOutBuffer, ch, 0, numSamples);
-        buffer.addFrom(ch, 0, hpfOutBuffer, ch, 0, numSamples);
+        const float* lpfOut { lpfOutBuffer.getReadPointer(ch) };
+        const float* bpfOut { bpfOutBuffer.getReadPointer(ch) };
+        const float* hpfOut { hpfOutBuffer.getReadPointer(ch) };
+        float* out { buffer.getWritePointer(ch) };
+        for (unsigned int n = 0; n < numSamples; ++n)
+        {
+            const float* c { control + n * NumControls };
+            out[n] = c[LPFControl] * lpfOut[n] + c[BPFControl] * bpfOut[n] + c[HPFControl] * hpfOut[n];
+        }
     }
 }
 
@@ -4,7 +4,7 @@
 
 #include "Oscillator.h"
 #include "StateVariableFilter.h"
-#include "Ramp.h"
+#include "SmootherBank.h"
 
 namespace Param
 {
@@ -98,18 +98,24 @@ private:
     float reso { 0.7071f };
     float mode { 0.5f };
 
-    DSP::StateVariableFilter svfLeft;
-    DSP::StateVariableFilter svfRight;
+    DSP::StateVariableFilter svf;
     DSP::Oscillator lfo;
-    DSP::Ramp<float> freqModAmtRamp;
-    DSP::Ramp<float> freqRamp;
-    DSP::Ramp<float> resoRamp;
-    DSP::Ramp<float> lpfRamp;
-    DSP::Ramp<float> bpfRamp;
-    DSP::Ramp<float> hpfRamp;
 
+    enum Control : unsigned int
+    {
+        FreqControl = 0,
+        FreqModAmtControl,
+        ResoControl,
+        LPFControl,
+        BPFControl,
+        HPFControl,
+        NumControls
+    };
+
+    DSP::SmootherBank<float, NumControls> controls;
+
+    juce::AudioBuffer<float> controlBuffer;
     juce::AudioBuffer<float> freqInBuffer;
-    juce::AudioBuffer<float> freqModAmtBuffer;
     juce::AudioBuffer<float> lfoBuffer;
     juce::AudioBuffer<float> resoInBuffer;
 
@@ -27,18 +27,6 @@ static const std::vector<mrta::ParameterInfo> ParameterInfos
 // SynthVoice Implementation
 SynthVoice::SynthVoice()
 {
-    oscillator1.initialise([](float x) { return std::sin(x); });
-    
-    oscillator2.initialise([](float x) {
-        // Band-limited sawtooth
-        constexpr int harmonics = 30;
-        float result = 0.0f;
-        
-        for (int i = 1; i <= harmonics; ++i)
-            result += std::sin(i * x) / i;
-        
-        return result * (2.0f / juce::MathConstants<float>::pi);
-    });
 }
 
 bool SynthVoice::canPlaySound(juce::SynthesiserSound* sound)
@@ -53,7 +41,7 @@ void SynthVoice::startNote(int midiNoteNumber, float velocity, juce::Synthesiser
     
     level = velocity;
     
-    auto freq = juce::MidiMessage::getMidiNoteInHertz(midiNoteNumber);
+    auto freq = static_cast<float>(juce::MidiMessage::getMidiNoteInHertz(midiNoteNumber));
     oscillator1.setFrequency(freq);
     oscillator2.setFrequency(freq);
 
@@ -93,32 +81,31 @@ void SynthVoice::renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int sta
     
     const juce::ScopedNoDenormals noDenormals;
 
-    juce::AudioBuffer<float> voiceBuffer(outputBuffer.getNumChannels(), numSamples);
-    voiceBuffer.clear();
-    
+    // Hosts may exceed the announced block size
+    if (numSamples > voiceBuffer.getNumSamples())
+    {
+        voiceBuffer.setSize(voiceBuffer.getNumChannels(), numSamples, false, false, true);
+        oscBuffer.setSize(oscBuffer.getNumChannels(), numSamples, false, false, true);
+    }
 
-    const int numChannels = std::max(2, voiceBuffer.getNumChannels());
+    const int numChannels = voiceBuffer.getNumChannels();
 
-    const float osc1Mix = 1.0f - oscMix;
-    const float osc2Mix = oscMix;
+    const float osc1Mix = (1.0f - oscMix) * level;
+    const float osc2Mix = oscMix * level;
 
-    for (int channel = 0; channel < numChannels; ++channel)
-    {
-        auto* channelData = voiceBuffer.getWritePointer(channel);
-        
-        // Process samples
-        for (int sample = 0; sample < numSamples; ++sample)
-        {
-            // Get oscillator samples (no phase offset - this could be a source of issues)
-            float osc1Sample = oscillator1.processSample(0.0f);
-            float osc2Sample = oscillator2.processSample(0.0f);
-            
-            // Mix the oscillators with proper levels
-            channelData[sample] = (osc1Sample * osc1Mix + osc2Sample * osc2Mix) * level;
-        }
-    }
-  
-    juce::dsp::AudioBlock<float> voiceBlock(voiceBuffer);
+    // Both oscillators run once per sample, the mono voice is copied to every channel
+    auto* voiceData = voiceBuffer.getWritePointer(0);
+    auto* osc2Data = oscBuffer.getWritePointer(0);
+    oscillator1.process(voiceData, static_cast<unsigned int>(numSamples));
+    oscillator2.process(osc2Data, static_cast<unsigned int>(numSamples));
+
+    for (int sample = 0; sample < numSamples; ++sample)
+        voiceData[sample] = voiceData[sample] * osc1Mix + osc2Data[sample] * osc2Mix;
+
+    for (int channel = 1; channel < numChannels; ++channel)
+        voiceBuffer.copyFrom(channel, 0, voiceBuffer, 0, 0, numSamples);
+
+    auto voiceBlock = juce::dsp::AudioBlock<float>(voiceBuffer).getSubBlock(0, static_cast<size_t>(numSamples));
     
     if (filterEnabled)
     {
@@ -152,11 +139,11 @@ void SynthVoice::prepareToPlay(double sampleRate, int samplesPerBlock)
     spec.maximumBlockSize = static_cast<juce::uint32>(samplesPerBlock);
     spec.numChannels = 2;
     
-    oscillator1.prepare(spec);
-    oscillator2.prepare(spec);
-    
-    oscillator1.reset();
-    oscillator2.reset();
+    oscillator1.prepare(sampleRate);
+    oscillator2.prepare(sampleRate);
+
+    voiceBuffer.setSize(static_cast<int>(spec.numChannels), samplesPerBlock);
+    oscBuffer.setSize(1, samplesPerBlock);
     
 
     filter.prepare(spec);
@@ -172,57 +159,10 @@ void SynthVoice::prepareToPlay(double sampleRate, int samplesPerBlock)
     masterGain.setGainLinear(0.7f); 
 }
 
-void SynthVoice::configureOscillatorWaveform(juce::dsp::Oscillator<float>& oscillator, int type)
+void SynthVoice::configureOscillatorWaveform(DSP::WavetableOscillator& oscillator, int type)
 {
-    switch (type)
-    {
-        case 0: // Sine wave - pure sine function
-            oscillator.initialise([](float x) { return std::sin(x); });
-            break;
-            
-        case 1: // Sawtooth wave - band-limited approximation
-            oscillator.initialise([](float x) {
-                constexpr int harmonics = 30;
-                float result = 0.0f;
-                
-                for (int i = 1; i <= harmonics; ++i)
-                    result += std::sin(i * x) / i;
-                
-                return result * (2.0f / juce::MathConstants<float>::pi);
-            });
-            break;
-            
-        case 2:
-            oscillator.initialise([](float x) {
-                constexpr int harmonics = 15;
-                float result = 0.0f;
-                
-                for (int i = 1; i <= harmonics * 2; i += 2)
-                    result += std::sin(i * x) / i;
-                
-                return result * (4.0f / juce::MathConstants<float>::pi);
-            });
-            break;
-            
-        case 3: // Triangle wave - band-limited approximation
-            oscillator.initialise([](float x) {
-                constexpr int harmonics = 15;
-                float result = 0.0f;
-                
-                for (int i = 1; i <= harmonics * 2; i += 2)
-                {
-                    float harmonic = std::sin(i * x) / (i * i);
-                    result += i % 4 == 1 ? harmonic : -harmonic;
-                }
-                
-                return result * (8.0f / (juce::MathConstants<float>::pi * juce::MathConstants<float>::pi));
-            });
-            break;
-            
-        default:
-            oscillator.initialise([](float x) { return std::sin(x); });
-    }
-    
+    // Choices are Sine, Saw, Square and Triangle, same order as the wavetables
+    oscillator.setWaveform(static_cast<DSP::WavetableOscillator::Waveform>(juce::jlimit(0, 3, type)));
     oscillator.reset();
 }
 
@@ -2,6 +2,8 @@
 
 #include <JuceHeader.h>
 
+#include "WavetableOscillator.h"
+
 namespace Param
 {
     namespace ID
@@ -77,16 +79,19 @@ public:
     void setMasterGain(float gain);
     
 private:
-    void configureOscillatorWaveform(juce::dsp::Oscillator<float>& oscillator, int type);
+    void configureOscillatorWaveform(DSP::WavetableOscillator& oscillator, int type);
 
 private:
     bool noteOn { false };
     int midiNote { 0 };
     float level { 0.0f };
     
-    juce::dsp::Oscillator<float> oscillator1;
-    juce::dsp::Oscillator<float> oscillator2;
+    DSP::WavetableOscillator oscillator1 { DSP::WavetableOscillator::Sin };
+    DSP::WavetableOscillator oscillator2 { DSP::WavetableOscillator::Saw };
     float oscMix { 0.5f };
+
+    juce::AudioBuffer<float> voiceBuffer;
+    juce::AudioBuffer<float> oscBuffer;
     
     juce::dsp::LadderFilter<float> filter;
     bool filterEnabled { true };
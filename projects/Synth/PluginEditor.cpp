@@ -2,7 +2,7 @@
 
 SynthAudioProcessorEditor::SynthAudioProcessorEditor(SynthAudioProcessor& p) :
     juce::AudioProcessorEditor(p), audioProcessor(p),
-    oscParamEditor(p.getParamManager(), PARAM_HEIGHT, { Param::ID::OscillatorSawVol, Param::ID::OscillatorTriVol, Param::ID::OscillatorSinVol, Param::ID::OscillatorVol, Param::ID::OutputVol }),
+    oscParamEditor(p.getParamManager(), PARAM_HEIGHT, { Param::ID::OscillatorSawVol, Param::ID::OscillatorTriVol, Param::ID::OscillatorSinVol, Param::ID::OscillatorVol, Param::ID::OscillatorSawVoices, Param::ID::OscillatorSawSpread, Param::ID::NoiseVol, Param::ID::NoiseType, Param::ID::OutputVol, Param::ID::ControlRate }),
     vcaEnvParamEditor(p.getParamManager(), PARAM_HEIGHT, { Param::ID::VCA_AttTime, Param::ID::VCA_DecayTime, Param::ID::VCA_Sustain, Param::ID::VCA_RelTime }),
     vcfEnvParamEditor(p.getParamManager(), PARAM_HEIGHT, { Param::ID::VCF_AttTime, Param::ID::VCF_DecayTime, Param::ID::VCF_Sustain, Param::ID::VCF_RelTime }),
     lfoParamEditor(p.getParamManager(), PARAM_HEIGHT, { Param::ID::VCF_LFOFreq, Param::ID::VCF_LFOType }),
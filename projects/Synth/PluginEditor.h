@@ -15,7 +15,7 @@ public:
     static constexpr int SECTION_WIDTH { 250 };
     static constexpr int SECTION_SPACER_WIDTH { 20 };
     static constexpr int LABEL_HEIGHT { 50 };
-    static constexpr int MAX_PARAM_COUNT { 5 };
+    static constexpr int MAX_PARAM_COUNT { 10 };
     static constexpr int PARAM_HEIGHT { 100 };
 
 private:
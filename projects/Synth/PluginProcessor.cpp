@@ -21,6 +21,26 @@ void setOscVol(std::vector<DSP::SynthVoice*> voices, float dB, bool skipRamp)
     std::for_each(voices.begin(), voices.end(), [dB, skipRamp] (auto& v) { v->setOscVol(dB, skipRamp); });
 }
 
+void setOscSawVoices(std::vector<DSP::SynthVoice*> voices, unsigned int numVoices)
+{
+    std::for_each(voices.begin(), voices.end(), [numVoices] (auto& v) { v->setOscSawVoices(numVoices); });
+}
+
+void setOscSawSpread(std::vector<DSP::SynthVoice*> voices, float norm)
+{
+    std::for_each(voices.begin(), voices.end(), [norm] (auto& v) { v->setOscSawSpread(norm); });
+}
+
+void setNoiseVol(std::vector<DSP::SynthVoice*> voices, float dB, bool skipRamp)
+{
+    std::for_each(voices.begin(), voices.end(), [dB, skipRamp] (auto& v) { v->setNoiseVol(dB, skipRamp); });
+}
+
+void setNoiseType(std::vector<DSP::SynthVoice*> voices, DSP::SynthVoice::NoiseType type)
+{
+    std::for_each(voices.begin(), voices.end(), [type] (auto& v) { v->setNoiseType(type); });
+}
+
 void setAttTimeVCA(std::vector<DSP::SynthVoice*> voices, float ms)
 {
     std::for_each(voices.begin(), voices.end(), [ms] (auto& v) { v->setAttTimeVCA(ms); });
@@ -108,6 +128,12 @@ static const std::vector<mrta::ParameterInfo> paramVector
     { Param::ID::OscillatorSinVol, Param::Name::OscillatorSinVol, Param::Units::dB, -12.f, Param::Ranges::VolMin, Param::Ranges::VolMax, Param::Ranges::VolInc, Param::Ranges::VolSkw },
     { Param::ID::OscillatorVol,    Param::Name::OscillatorVol,    Param::Units::dB,   0.f, Param::Ranges::VolMin, Param::Ranges::VolMax, Param::Ranges::VolInc, Param::Ranges::VolSkw },
 
+    { Param::ID::OscillatorSawVoices, Param::Name::OscillatorSawVoices, "", 1.f, Param::Ranges::VoicesMin, Param::Ranges::VoicesMax, Param::Ranges::VoicesInc, Param::Ranges::VoicesSkw },
+    { Param::ID::OscillatorSawSpread, Param::Name::OscillatorSawSpread, "", 0.f, Param::Ranges::SpreadMin, Param::Ranges::SpreadMax, Param::Ranges::SpreadInc, Param::Ranges::SpreadSkw },
+
+    { Param::ID::NoiseVol,  Param::Name::NoiseVol,  Param::Units::dB, Param::Ranges::VolMin, Param::Ranges::VolMin, Param::Ranges::VolMax, Param::Ranges::VolInc, Param::Ranges::VolSkw },
+    { Param::ID::NoiseType, Param::Name::NoiseType, Param::Ranges::NoiseType, 0 },
+
     { Param::ID::VCA_AttTime,   Param::Name::VCA_AttTime,   Param::Units::Ms,  50.0f, Param::Ranges::EnvTimeMin,    Param::Ranges::EnvTimeMax,    Param::Ranges::EnvTimeInc,    Param::Ranges::EnvTimeSkw },
     { Param::ID::VCA_DecayTime, Param::Name::VCA_DecayTime, Param::Units::Ms,  10.0f, Param::Ranges::EnvTimeMin,    Param::Ranges::EnvTimeMax,    Param::Ranges::EnvTimeInc,    Param::Ranges::EnvTimeSkw },
     { Param::ID::VCA_Sustain,   Param::Name::VCA_Sustain,   "",                 0.7f, Param::Ranges::EnvSustainMin, Param::Ranges::EnvSustainMax, Param::Ranges::EnvSustainInc, Param::Ranges::EnvSustainSkw },
@@ -128,7 +154,8 @@ static const std::vector<mrta::ParameterInfo> paramVector
     { Param::ID::VCF_EnvAmount, Param::Name::VCF_EnvAmount, "", 0.f, Param::Ranges::AmountMin, Param::Ranges::AmountMax, Param::Ranges::AmountInc, Param::Ranges::AmountSkw },
     { Param::ID::VCF_LFOAmount, Param::Name::VCF_LFOAmount, "", 0.f, Param::Ranges::AmountMin, Param::Ranges::AmountMax, Param::Ranges::AmountInc, Param::Ranges::AmountSkw },
 
-    { Param::ID::OutputVol, Param::Name::OutputVol, Param::Units::dB, 0.f, Param::Ranges::VolMin, Param::Ranges::VolMax, Param::Ranges::VolInc, Param::Ranges::VolSkw }
+    { Param::ID::OutputVol, Param::Name::OutputVol, Param::Units::dB, 0.f, Param::Ranges::VolMin, Param::Ranges::VolMax, Param::Ranges::VolInc, Param::Ranges::VolSkw },
+    { Param::ID::ControlRate, Param::Name::ControlRate, Param::Ranges::ControlRate, 0 }
 };
 
 SynthAudioProcessor::SynthAudioProcessor() :
@@ -137,7 +164,7 @@ SynthAudioProcessor::SynthAudioProcessor() :
     synth.addSound(new DSP::SynthSound());
     for (size_t i = 0; i < NUM_VOICES; ++i)
     {
-        voices.emplace_back(new DSP::SynthVoice());
+        voices.emplace_back(new DSP::SynthVoice(synth, static_cast<unsigned int>(i)));
         synth.addVoice(voices.back());
     }
     synth.setNoteStealingEnabled(false);
@@ -146,6 +173,10 @@ SynthAudioProcessor::SynthAudioProcessor() :
     paramManager.registerParameterCallback(Param::ID::OscillatorTriVol, [this] (float value, bool force) { setOscTriVol(voices, value, force); });
     paramManager.registerParameterCallback(Param::ID::OscillatorSinVol, [this] (float value, bool force) { setOscSinVol(voices, value, force); });
     paramManager.registerParameterCallback(Param::ID::OscillatorVol, [this] (float value, bool force) { setOscVol(voices, value, force); });
+    paramManager.registerParameterCallback(Param::ID::OscillatorSawVoices, [this] (float value, bool force) { setOscSawVoices(voices, static_cast<unsigned int>(std::round(value))); });
+    paramManager.registerParameterCallback(Param::ID::OscillatorSawSpread, [this] (float value, bool force) { setOscSawSpread(voices, value); });
+    paramManager.registerParameterCallback(Param::ID::NoiseVol, [this] (float value, bool force) { setNoiseVol(voices, value, force); });
+    paramManager.registerParameterCallback(Param::ID::NoiseType, [this] (float value, bool force) { setNoiseType(voices, static_cast<DSP::SynthVoice::NoiseType>(std::round(value))); });
     paramManager.registerParameterCallback(Param::ID::VCA_AttTime, [this] (float value, bool force) { setAttTimeVCA(voices, value); });
     paramManager.registerParameterCallback(Param::ID::VCA_DecayTime, [this] (float value, bool force) { setDecayTimeVCA(voices, value); });
     paramManager.registerParameterCallback(Param::ID::VCA_Sustain, [this] (float value, bool force) { setSustainVCA(voices, value); });
@@ -162,6 +193,7 @@ SynthAudioProcessor::SynthAudioProcessor() :
     paramManager.registerParameterCallback(Param::ID::VCF_EnvAmount, [this] (float value, bool force) { setEnvAmountVCF(voices, value, force); });
     paramManager.registerParameterCallback(Param::ID::VCF_LFOAmount, [this] (float value, bool force) { setLFOAmountVCF(voices, value, force); });
     paramManager.registerParameterCallback(Param::ID::OutputVol, [this] (float value, bool force) { setOutputVol(voices, value, force); });
+    paramManager.registerParameterCallback(Param::ID::ControlRate, [this] (float value, bool force) { synth.setControlRate(static_cast<DSP::SynthVoice::ControlRate>(std::round(value))); });
 }
 
 SynthAudioProcessor::~SynthAudioProcessor()
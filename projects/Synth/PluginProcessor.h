@@ -11,7 +11,12 @@ namespace Param
         static const juce::String OscillatorTriVol { "oscillator_tri_vol" };
         static const juce::String OscillatorSinVol { "oscillator_sin_vol" };
         static const juce::String OscillatorVol { "oscillator_volume" };
+        static const juce::String OscillatorSawVoices { "oscillator_saw_voices" };
+        static const juce::String OscillatorSawSpread { "oscillator_saw_spread" };
+        static const juce::String NoiseVol { "noise_vol" };
+        static const juce::String NoiseType { "noise_type" };
         static const juce::String OutputVol { "output_vol" };
+        static const juce::String ControlRate { "control_rate" };
 
         static const juce::String VCA_AttTime { "vca_att_time" };
         static const juce::String VCA_DecayTime { "vca_decay_time" };
@@ -39,7 +44,12 @@ namespace Param
         static const juce::String OscillatorTriVol { "Osc. Tri Vol." };
         static const juce::String OscillatorSinVol { "Osc. Sin Vol." };
         static const juce::String OscillatorVol { "Osc. Vol." };
+        static const juce::String OscillatorSawVoices { "Osc. Saw Voices" };
+        static const juce::String OscillatorSawSpread { "Osc. Saw Spread" };
+        static const juce::String NoiseVol { "Noise Vol." };
+        static const juce::String NoiseType { "Noise Type" };
         static const juce::String OutputVol { "Output Vol." };
+        static const juce::String ControlRate { "Control Rate" };
 
         static const juce::String VCA_AttTime { "VCA Attack Time" };
         static const juce::String VCA_DecayTime { "VCA Decay Time" };
@@ -64,11 +74,22 @@ namespace Param
 
     namespace Ranges
     {
+        // The noise is off at the minimum volume, see DSP::SynthVoice::NoiseOffDb
         static constexpr float VolMin { -60.f };
         static constexpr float VolMax { 12.f };
         static constexpr float VolInc { 0.1f };
         static constexpr float VolSkw { 2.8f };
 
+        static constexpr float VoicesMin { 1.f };
+        static constexpr float VoicesMax { 16.f };
+        static constexpr float VoicesInc { 1.f };
+        static constexpr float VoicesSkw { 1.f };
+
+        static constexpr float SpreadMin { 0.f };
+        static constexpr float SpreadMax { 1.f };
+        static constexpr float SpreadInc { 0.001f };
+        static constexpr float SpreadSkw { 1.f };
+
         static constexpr float EnvTimeMin { 1.f };
         static constexpr float EnvTimeMax { 1000.f };
         static constexpr float EnvTimeInc { 1.f };
@@ -99,8 +120,10 @@ namespace Param
         static constexpr float AmountInc { 0.001f };
         static constexpr float AmountSkw { 1.f };
 
+        static const juce::StringArray NoiseType { "White", "Pink", "Brown" };
         static const juce::StringArray LFOType { "Sin", "Tri" };
         static const juce::StringArray FilterType { "Low Pass", "Band Pass", "High Pass" };
+        static const juce::StringArray ControlRate { "Audio Rate", "8 Samples", "16 Samples", "32 Samples" };
     }
 
     namespace Units
@@ -141,12 +164,12 @@ public:
     void changeProgramName(int, const juce::String&) override;
     //==============================================================================
 
-    static constexpr size_t NUM_VOICES { 8 };
+    static constexpr size_t NUM_VOICES { DSP::Synth::MaxVoices };
 
 private:
     mrta::ParameterManager paramManager;
     std::vector<DSP::SynthVoice*> voices;
-    juce::Synthesiser synth;
+    DSP::Synth synth;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SynthAudioProcessor)
 };
\ No newline at end of file